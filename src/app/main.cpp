@@ -5,8 +5,14 @@
 #include "../config/config_manager.hpp"
 #include "../voxel/world.hpp"
 #include "../voxel/world_manager.hpp"
+#include "../voxel/edit_journal.hpp"
+#include "../voxel/chunk_dims.hpp"
+#include "../voxel/storage_pool.hpp"
+#include "../voxel/block_registry.hpp"
 #include "../mesh/greedy_mesher.hpp"
+#include "../mesh/binary_mesher.hpp"
 #include "../render/gl_app.hpp"
+#include <algorithm>
 #include <filesystem>
 #include <chrono>
 #include <iomanip>
@@ -89,40 +95,71 @@ int main() {
 		std::string configPath = std::filesystem::absolute(configManager.getConfigPath("engine.ini")).string();
 		core::log(core::LogLevel::Warn, "Failed to load " + configPath + ", using defaults.");
 	}
+	// Block definitions must be in place before anything is meshed
+	if (!configManager.ensureConfigExists("blocks.ini") || !voxel::blockRegistry().loadFromFile(configManager.getConfigPath("blocks.ini"))) {
+		core::log(core::LogLevel::Warn, "Failed to load blocks.ini, using built-in air and dirt only.");
+	}
 	const auto& dims = config::Config::instance().chunk();
-	core::log(core::LogLevel::Info, "Chunk dims: " + std::to_string(dims.sizeX) + "x" + std::to_string(dims.sizeY) + "x" + std::to_string(dims.sizeZ));
+	core::log(core::LogLevel::Info, "Chunk dims: " + std::to_string(dims.sizeX) + "x" + std::to_string(dims.sizeY) + "x" + std::to_string(dims.sizeZ)
+		+ (voxel::hasFixedChunkDims(dims.sizeX, dims.sizeY, dims.sizeZ) ? " (specialized)" : " (generic; use 8/16/32/64 cubes for specialized paths)"));
 
 	// Smoke test chunk create + serialize
-    voxel::World world;
-    voxel::WorldManager wm(world);
-    wm.setViewDistance(2);
-    wm.updatePlayerPosition(0.0f, 0.0f, 0.0f);
-    voxel::Chunk& c = world.getOrCreateChunk(0, 0);
-    voxel::Voxel v; v.type = voxel::BlockType::Dirt;
-    for (int z = 0; z < 4; ++z) {
-        for (int y = 0; y < 4; ++y) {
-            for (int x = 0; x < 4; ++x) {
-                c.at(x, y, z) = v;
-            }
-        }
-    }
     // Get executable directory and create data subdirectory
     std::string exePath = std::filesystem::current_path().string();
     std::string dataDir = exePath + "/data";
     std::filesystem::create_directories(dataDir);
-    std::string chunkFilename = dataDir + "/chunk_0_0.vxl";
-    c.saveToFile(chunkFilename.c_str());
-    std::string chunkPath = std::filesystem::absolute(chunkFilename).string();
-    core::log(core::LogLevel::Info, "Saved chunk to " + chunkPath);
+    // Edits are journaled as they happen; whatever a previous run left in
+    // the journal is replayed over the saved sections first
+    voxel::EditJournal journal;
+    voxel::World world;
+    voxel::WorldManager wm(world);
+    wm.setSaveDirectory(dataDir);
+    if (journal.open(dataDir + "/edits.vjl")) {
+        wm.setJournal(&journal);
+        core::log(core::LogLevel::Info, "Journal: replayed " + std::to_string(wm.replayJournal()) + " edit runs from " + journal.path());
+    } else {
+        core::log(core::LogLevel::Warn, "Failed to open the edit journal; edits are only kept by explicit saves.");
+    }
+    wm.setViewDistance(2);
+    wm.updatePlayerPosition(0.0f, 0.0f, 0.0f);
+    core::log(core::LogLevel::Info, "World: chunks=" + std::to_string(world.chunkCount()) + ", voxel bytes=" + std::to_string(world.memoryUsage()));
+    wm.fillBox(0, 0, 0, 3, 3, 3, voxel::BlockType::Dirt);
+    voxel::Chunk& c = world.getOrCreateChunk(0, 0, 0);
+    // Only sections holding blocks are written; all-air sections are skipped
+    int savedSections = wm.checkpoint();
+    std::string chunkPath = std::filesystem::absolute(wm.regionPath(0, 0, 0)).string();
+    core::log(core::LogLevel::Info, "Checkpointed " + std::to_string(savedSections) + " of " + std::to_string(world.chunkCount()) + " sections (region files, e.g. " + chunkPath + ")");
+    const voxel::StoragePoolStats ps = voxel::storagePool().stats();
+    core::log(core::LogLevel::Info, "Storage pool: hits=" + std::to_string(ps.hits) + ", misses=" + std::to_string(ps.misses)
+        + ", pooled bytes=" + std::to_string(ps.pooledBytes));
 
     // Build mesh for this chunk
     mesh::GreedyMesher gm;
+    auto meshStart = std::chrono::steady_clock::now();
     mesh::Mesh m = gm.buildMesh(c);
+    auto meshEnd = std::chrono::steady_clock::now();
     core::log(core::LogLevel::Info, "Mesh: vertices=" + std::to_string(m.vertices.size()) + ", indices=" + std::to_string(m.indices.size()));
+    // Before/after merge report: one quad per exposed face vs. merged quads
+    const mesh::MeshStats& ms = gm.lastStats();
+    core::log(core::LogLevel::Info, "Greedy merge: faces=" + std::to_string(ms.exposedFaces) + " -> quads=" + std::to_string(ms.quads)
+        + ", vertices " + std::to_string(ms.exposedFaces * 4) + " -> " + std::to_string(m.vertices.size()));
+
+    // A/B against the bitmask mesher: identical output expected
+    mesh::BinaryMesher bm;
+    auto binStart = std::chrono::steady_clock::now();
+    mesh::Mesh mb = bm.buildMesh(c);
+    auto binEnd = std::chrono::steady_clock::now();
+    bool same = mb.indices == m.indices && mb.vertices.size() == m.vertices.size()
+        && std::equal(mb.vertices.begin(), mb.vertices.end(), m.vertices.begin(), [](const mesh::Vertex& a, const mesh::Vertex& b) {
+            return a.x == b.x && a.y == b.y && a.z == b.z && a.nx == b.nx && a.ny == b.ny && a.nz == b.nz && a.u == b.u && a.v == b.v;
+        });
+    auto us = [](auto a, auto b) { return std::to_string(std::chrono::duration_cast<std::chrono::microseconds>(b - a).count()); };
+    core::log(same ? core::LogLevel::Info : core::LogLevel::Warn, "Binary mesher: vertices=" + std::to_string(mb.vertices.size())
+        + (same ? " (matches greedy)" : " (MISMATCH vs greedy)") + ", greedy " + us(meshStart, meshEnd) + "us, binary " + us(binStart, binEnd) + "us");
 
 #ifdef VOXEL_WITH_GL
     core::log(core::LogLevel::Info, "GL demo: enabled (opening window)...");
-    render::run_demo(world, gm);
+    render::run_demo(world, wm, gm);
 #else
     core::log(core::LogLevel::Info, "GL demo: disabled (VOXEL_WITH_GL=OFF)");
 #endif
@@ -0,0 +1,114 @@
+#include "bench_util.hpp"
+#include "../mesh/greedy_mesher.hpp"
+#include "../voxel/column_rle_storage.hpp"
+
+#include <cstdio>
+#include <random>
+
+namespace bench {
+
+// Keeps benchmark results observable so the work is not optimized away
+static volatile long long g_sink = 0;
+
+// Dense (palette Chunk) against column-run storage on the same corpus:
+// footprint, random reads, full unpack, heightmap, meshing and random edits.
+// The dense heightmap is computed from scratch by scanning each column down,
+// as a generator or loader would; Chunk's cached columnHeight is not used.
+int runBackendBench(int size) {
+	const auto corpus = makeCorpus(size, size, size);
+	CacheMissCounter counter;
+	std::printf("backend bench: %dx%dx%d chunks%s\n", size, size, size, counter.available() ? "" : " (cache-miss counters unavailable)");
+
+	// Fixed coordinate set so both backends read and write identical voxels
+	struct Coord { int x, y, z; };
+	std::vector<Coord> coords(1 << 16);
+	std::mt19937 rng(7);
+	std::uniform_int_distribution<int> pos(0, size - 1);
+	for (Coord& c : coords) c = Coord{ pos(rng), pos(rng), pos(rng) };
+	const std::size_t voxels = static_cast<std::size_t>(size) * size * size;
+	const std::size_t columns = static_cast<std::size_t>(size) * size;
+	std::vector<voxel::BlockType> types(voxels);
+
+	for (const CorpusChunk& entry : corpus) {
+		voxel::Chunk dense(size, size, size);
+		fillChunk(dense, entry.types);
+		const voxel::ColumnRleStorage rle(dense);
+		std::printf("%s: dense %zu bytes, rle %zu bytes (%zu runs)\n", entry.name.c_str(),
+			dense.memoryUsage(), rle.memoryUsage(), rle.runCount());
+
+		long long sum = 0;
+		counter.start();
+		Timer tg;
+		for (const Coord& c : coords) sum += static_cast<int>(dense.get(c.x, c.y, c.z));
+		report("dense get", tg.elapsedNs() / coords.size(), counter.stop(), coords.size());
+		counter.start();
+		Timer tgr;
+		for (const Coord& c : coords) sum += static_cast<int>(rle.get(c.x, c.y, c.z));
+		report("rle get", tgr.elapsedNs() / coords.size(), counter.stop(), coords.size());
+
+		const int reps = 20;
+		counter.start();
+		Timer tc;
+		for (int i = 0; i < reps; ++i) dense.copyTypes(types.data());
+		report("dense copyTypes (per voxel)", tc.elapsedNs() / (reps * voxels), counter.stop(), reps * voxels);
+		counter.start();
+		Timer tcr;
+		for (int i = 0; i < reps; ++i) rle.copyTypes(types.data());
+		report("rle copyTypes (per voxel)", tcr.elapsedNs() / (reps * voxels), counter.stop(), reps * voxels);
+
+		counter.start();
+		Timer th;
+		for (int i = 0; i < reps; ++i) {
+			for (int z = 0; z < size; ++z) {
+				for (int x = 0; x < size; ++x) {
+					int y = size - 1;
+					while (y >= 0 && dense.get(x, y, z) == voxel::BlockType::Air) --y;
+					sum += y + 1;
+				}
+			}
+		}
+		report("dense heightmap scan (per column)", th.elapsedNs() / (reps * columns), counter.stop(), reps * columns);
+		counter.start();
+		Timer thr;
+		for (int i = 0; i < reps; ++i) {
+			for (int z = 0; z < size; ++z)
+				for (int x = 0; x < size; ++x) sum += rle.columnHeight(x, z);
+		}
+		report("rle heightmap (per column)", thr.elapsedNs() / (reps * columns), counter.stop(), reps * columns);
+
+		mesh::GreedyMesher mesher;
+		counter.start();
+		Timer tm;
+		for (int i = 0; i < reps; ++i) sum += static_cast<long long>(mesher.buildMesh(dense).vertices.size());
+		report("dense GreedyMesher::buildMesh", tm.elapsedNs() / reps, counter.stop(), reps);
+		counter.start();
+		Timer tmr;
+		for (int i = 0; i < reps; ++i) sum += static_cast<long long>(mesher.buildMesh(rle).vertices.size());
+		report("rle GreedyMesher::buildMesh", tmr.elapsedNs() / reps, counter.stop(), reps);
+
+		// Edits on copies so the read passes above saw the corpus as generated
+		voxel::Chunk denseEdit(size, size, size);
+		denseEdit.assignTypes(entry.types.data());
+		voxel::ColumnRleStorage rleEdit(rle);
+		const std::size_t edits = coords.size() / 4;
+		Timer ts;
+		for (std::size_t i = 0; i < edits; ++i) {
+			const Coord& c = coords[i];
+			denseEdit.set(c.x, c.y, c.z, (i & 1) ? voxel::BlockType::Dirt : voxel::BlockType::Air);
+		}
+		report("dense set", ts.elapsedNs() / edits, -1, edits);
+		Timer tsr;
+		for (std::size_t i = 0; i < edits; ++i) {
+			const Coord& c = coords[i];
+			rleEdit.set(c.x, c.y, c.z, (i & 1) ? voxel::BlockType::Dirt : voxel::BlockType::Air);
+		}
+		report("rle set", tsr.elapsedNs() / edits, -1, edits);
+		std::printf("  after edits: dense %zu bytes, rle %zu bytes (%zu runs)\n",
+			denseEdit.memoryUsage(), rleEdit.memoryUsage(), rleEdit.runCount());
+
+		g_sink = sum;
+	}
+	return 0;
+}
+
+} // namespace bench
@@ -0,0 +1,39 @@
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+namespace bench {
+int runLayoutBench(int size);
+int runEditBench();
+int runCursorBench();
+int runBackendBench(int size);
+int runCodecBench(int size);
+int runStreamBench();
+int runReaderBench();
+int runJournalBench();
+}
+
+// Usage: voxel_bench [suite] [chunk size]
+//   suite: layout | edit | cursor | backend | codec | stream | reader | journal | all (default all)
+int main(int argc, char** argv) {
+	const std::string suite = argc > 1 ? argv[1] : "all";
+	const int size = argc > 2 ? std::atoi(argv[2]) : 32;
+	if (size <= 0 || size > 256) {
+		std::fprintf(stderr, "chunk size must be in 1..256\n");
+		return 1;
+	}
+	bool ran = false;
+	if (suite == "layout" || suite == "all") { bench::runLayoutBench(size); ran = true; }
+	if (suite == "edit" || suite == "all") { bench::runEditBench(); ran = true; }
+	if (suite == "cursor" || suite == "all") { bench::runCursorBench(); ran = true; }
+	if (suite == "backend" || suite == "all") { bench::runBackendBench(size); ran = true; }
+	if (suite == "codec" || suite == "all") { bench::runCodecBench(size); ran = true; }
+	if (suite == "stream" || suite == "all") { bench::runStreamBench(); ran = true; }
+	if (suite == "reader" || suite == "all") { bench::runReaderBench(); ran = true; }
+	if (suite == "journal" || suite == "all") { bench::runJournalBench(); ran = true; }
+	if (!ran) {
+		std::fprintf(stderr, "unknown suite '%s' (expected: layout, edit, cursor, backend, codec, stream, reader, journal, all)\n", suite.c_str());
+		return 1;
+	}
+	return 0;
+}
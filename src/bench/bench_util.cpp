@@ -0,0 +1,115 @@
+#include "bench_util.hpp"
+
+#include <cmath>
+#include <cstdio>
+#include <random>
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <cstring>
+#endif
+
+namespace bench {
+
+CacheMissCounter::CacheMissCounter() {
+#if defined(__linux__)
+	perf_event_attr attr;
+	std::memset(&attr, 0, sizeof(attr));
+	attr.size = sizeof(attr);
+	attr.type = PERF_TYPE_HARDWARE;
+	attr.config = PERF_COUNT_HW_CACHE_MISSES;
+	attr.disabled = 1;
+	attr.exclude_kernel = 1;
+	attr.exclude_hv = 1;
+	fd_ = static_cast<int>(syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0));
+#endif
+}
+
+CacheMissCounter::~CacheMissCounter() {
+#if defined(__linux__)
+	if (fd_ >= 0) close(fd_);
+#endif
+}
+
+void CacheMissCounter::start() {
+#if defined(__linux__)
+	if (fd_ < 0) return;
+	ioctl(fd_, PERF_EVENT_IOC_RESET, 0);
+	ioctl(fd_, PERF_EVENT_IOC_ENABLE, 0);
+#endif
+}
+
+long long CacheMissCounter::stop() {
+#if defined(__linux__)
+	if (fd_ < 0) return -1;
+	ioctl(fd_, PERF_EVENT_IOC_DISABLE, 0);
+	long long count = 0;
+	if (read(fd_, &count, sizeof(count)) != static_cast<ssize_t>(sizeof(count))) return -1;
+	return count;
+#else
+	return -1;
+#endif
+}
+
+std::vector<CorpusChunk> makeCorpus(int sx, int sy, int sz) {
+	const std::size_t volume = static_cast<std::size_t>(sx) * sy * sz;
+	auto idx = [&](int x, int y, int z) { return (static_cast<std::size_t>(y) * sz + z) * sx + x; };
+	std::vector<CorpusChunk> corpus;
+	std::mt19937 rng(1234);
+
+	{
+		CorpusChunk c{"terrain", std::vector<voxel::BlockType>(volume, voxel::BlockType::Air)};
+		for (int z = 0; z < sz; ++z) {
+			for (int x = 0; x < sx; ++x) {
+				const double h = sy * (0.5 + 0.2 * std::sin(x * 0.3) * std::cos(z * 0.25));
+				for (int y = 0; y < sy && y < static_cast<int>(h); ++y) c.types[idx(x, y, z)] = voxel::BlockType::Dirt;
+			}
+		}
+		corpus.push_back(std::move(c));
+	}
+	{
+		CorpusChunk c{"caves", std::vector<voxel::BlockType>(volume, voxel::BlockType::Dirt)};
+		for (int y = 0; y < sy; ++y) {
+			for (int z = 0; z < sz; ++z) {
+				for (int x = 0; x < sx; ++x) {
+					const double n = std::sin(x * 0.4) + std::sin(y * 0.5 + 1.0) + std::sin(z * 0.45 + 2.0);
+					if (n > 1.2 || y > sy * 3 / 4) c.types[idx(x, y, z)] = voxel::BlockType::Air;
+				}
+			}
+		}
+		corpus.push_back(std::move(c));
+	}
+	{
+		CorpusChunk c{"noise", std::vector<voxel::BlockType>(volume, voxel::BlockType::Air)};
+		for (auto& t : c.types) if (rng() % 4 == 0) t = voxel::BlockType::Dirt;
+		corpus.push_back(std::move(c));
+	}
+	{
+		CorpusChunk c{"slab", std::vector<voxel::BlockType>(volume, voxel::BlockType::Air)};
+		for (int y = 0; y < sy / 2; ++y)
+			for (int z = 0; z < sz; ++z)
+				for (int x = 0; x < sx; ++x) c.types[idx(x, y, z)] = voxel::BlockType::Dirt;
+		corpus.push_back(std::move(c));
+	}
+	return corpus;
+}
+
+void fillChunk(voxel::Chunk& chunk, const std::vector<voxel::BlockType>& types) {
+	std::size_t i = 0;
+	for (int y = 0; y < chunk.sizeY(); ++y)
+		for (int z = 0; z < chunk.sizeZ(); ++z)
+			for (int x = 0; x < chunk.sizeX(); ++x) chunk.set(x, y, z, types[i++]);
+}
+
+void report(const std::string& name, double nsPerOp, long long misses, std::size_t ops) {
+	if (misses >= 0) {
+		std::printf("  %-40s %12.1f ns/op %12.2f misses/op\n", name.c_str(), nsPerOp, static_cast<double>(misses) / static_cast<double>(ops));
+	} else {
+		std::printf("  %-40s %12.1f ns/op %12s\n", name.c_str(), nsPerOp, "n/a");
+	}
+}
+
+} // namespace bench
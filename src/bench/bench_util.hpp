@@ -0,0 +1,58 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "../voxel/chunk.hpp"
+
+namespace bench {
+
+// Wall-clock stopwatch in nanoseconds
+class Timer {
+public:
+	Timer() : start_(std::chrono::steady_clock::now()) {}
+	double elapsedNs() const {
+		return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start_).count();
+	}
+private:
+	std::chrono::steady_clock::time_point start_;
+};
+
+// Hardware cache-miss counter for the calling thread (Linux perf events).
+// available() is false where perf is not permitted or not supported, in
+// which case benchmarks report timings only.
+class CacheMissCounter {
+public:
+	CacheMissCounter();
+	~CacheMissCounter();
+	CacheMissCounter(const CacheMissCounter&) = delete;
+	CacheMissCounter& operator=(const CacheMissCounter&) = delete;
+
+	bool available() const { return fd_ >= 0; }
+	void start();
+	// Misses since start(), or -1 when unavailable
+	long long stop();
+
+private:
+	int fd_ {-1};
+};
+
+// One named chunk shape in the benchmark corpus
+struct CorpusChunk {
+	std::string name;
+	std::vector<voxel::BlockType> types; // linear order, (y * sz + z) * sx + x
+};
+
+// Deterministic set of chunk contents shared by all benchmarks:
+// rolling terrain, layered terrain with caves, sparse noise, and a
+// half-filled slab.
+std::vector<CorpusChunk> makeCorpus(int sx, int sy, int sz);
+
+// Fill a chunk from linear-order types
+void fillChunk(voxel::Chunk& chunk, const std::vector<voxel::BlockType>& types);
+
+// Print one result row: name, ns per op, and misses per op when counted
+void report(const std::string& name, double nsPerOp, long long misses, std::size_t ops);
+
+} // namespace bench
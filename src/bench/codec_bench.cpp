@@ -0,0 +1,62 @@
+#include "bench_util.hpp"
+
+#include <cstdio>
+#include <cstring>
+
+namespace bench {
+
+// Keeps benchmark results observable so the work is not optimized away
+static volatile long long g_sink = 0;
+
+// Old raw 'VCXL' bytes for a chunk: magic, three ints, one byte per voxel
+static std::vector<std::uint8_t> encodeVersion1(const voxel::Chunk& chunk) {
+	const std::uint32_t magic = 0x5643584C;
+	const int dims[3] = { chunk.sizeX(), chunk.sizeY(), chunk.sizeZ() };
+	const std::size_t count = static_cast<std::size_t>(dims[0]) * dims[1] * dims[2];
+	std::vector<std::uint8_t> out(sizeof(magic) + sizeof(dims) + count);
+	std::memcpy(out.data(), &magic, sizeof(magic));
+	std::memcpy(out.data() + sizeof(magic), dims, sizeof(dims));
+	chunk.copyTypes(reinterpret_cast<voxel::BlockType*>(out.data() + sizeof(magic) + sizeof(dims)));
+	return out;
+}
+
+// Saved size and encode/decode cost of the chunk format, against the old
+// raw format, over the shared corpus. Throughput is in decoded voxel bytes.
+int runCodecBench(int size) {
+	const auto corpus = makeCorpus(size, size, size);
+	std::printf("codec bench: %dx%dx%d chunks\n", size, size, size);
+	const std::size_t voxels = static_cast<std::size_t>(size) * size * size;
+	const int reps = 200;
+
+	for (const CorpusChunk& entry : corpus) {
+		voxel::Chunk chunk(size, size, size);
+		fillChunk(chunk, entry.types);
+		const std::vector<std::uint8_t> v1 = encodeVersion1(chunk);
+		std::vector<std::uint8_t> v2;
+		chunk.saveToBuffer(v2);
+		std::printf("%s: v1 %zu bytes, v2 %zu bytes (%.1fx smaller)\n", entry.name.c_str(),
+			v1.size(), v2.size(), static_cast<double>(v1.size()) / static_cast<double>(v2.size()));
+
+		Timer te;
+		for (int i = 0; i < reps; ++i) chunk.saveToBuffer(v2);
+		report("v2 saveToBuffer (per voxel)", te.elapsedNs() / (reps * voxels), -1, reps * voxels);
+
+		voxel::Chunk loaded(size, size, size);
+		long long sum = 0;
+		Timer t1;
+		for (int i = 0; i < reps; ++i) sum += loaded.loadFromBuffer(v1.data(), v1.size());
+		double ns = t1.elapsedNs();
+		report("v1 loadFromBuffer (per voxel)", ns / (reps * voxels), -1, reps * voxels);
+		std::printf("  %-40s %12.0f MB/s\n", "v1 load throughput", reps * voxels / ns * 1e3);
+
+		Timer t2;
+		for (int i = 0; i < reps; ++i) sum += loaded.loadFromBuffer(v2.data(), v2.size());
+		ns = t2.elapsedNs();
+		report("v2 loadFromBuffer (per voxel)", ns / (reps * voxels), -1, reps * voxels);
+		std::printf("  %-40s %12.0f MB/s\n", "v2 load throughput", reps * voxels / ns * 1e3);
+		g_sink = sum + static_cast<long long>(loaded.solidCount());
+	}
+	return 0;
+}
+
+} // namespace bench
@@ -0,0 +1,69 @@
+#include "bench_util.hpp"
+#include "../config/config.hpp"
+#include "../voxel/voxel_cursor.hpp"
+#include "../voxel/world_manager.hpp"
+
+#include <cstdio>
+
+namespace bench {
+
+static volatile long long g_sink = 0;
+
+// 6-neighbour sweep over a multi-section region (lighting/physics style),
+// once through WorldManager::tryGetVoxel and once with a VoxelCursor that
+// walks each X row and peeks at neighbours.
+int runCursorBench() {
+	const config::Config& cfg = config::Config::instance();
+	const int y0 = cfg.world().min_section_y * cfg.chunk().sizeY;
+	const int y1 = (cfg.world().max_section_y + 1) * cfg.chunk().sizeY - 1;
+	const int span = 128;
+
+	voxel::World world;
+	voxel::WorldManager wm(world);
+	// Rolling ground with a few spheres carved out, so sections are mixed
+	wm.fillBox(-1, y0, -1, span, (y0 + y1) / 2, span, voxel::BlockType::Dirt);
+	for (int i = 0; i < 8; ++i) {
+		wm.fillSphere(16 + i * 13, (y0 + y1) / 2, 20 + (i * 37) % 90, 9, voxel::BlockType::Air);
+	}
+	const std::size_t voxels = static_cast<std::size_t>(span) * span * (y1 - y0 + 1);
+	std::printf("cursor bench: %dx%dx%d region, 6-neighbour sweep\n", span, y1 - y0 + 1, span);
+
+	long long viaLookup = 0;
+	Timer tl;
+	for (int y = y0; y <= y1; ++y) {
+		for (int z = 0; z < span; ++z) {
+			for (int x = 0; x < span; ++x) {
+				static const int offs[6][3] = { {1,0,0}, {-1,0,0}, {0,1,0}, {0,-1,0}, {0,0,1}, {0,0,-1} };
+				for (const auto& o : offs) {
+					voxel::Voxel v;
+					if (wm.tryGetVoxel(x + o[0], y + o[1], z + o[2], v) && v.type != voxel::BlockType::Air) ++viaLookup;
+				}
+			}
+		}
+	}
+	report("tryGetVoxel (per voxel)", tl.elapsedNs() / voxels, -1, voxels);
+
+	long long viaCursor = 0;
+	Timer tc;
+	voxel::VoxelCursor cur(world, 0, y0, 0);
+	for (int y = y0; y <= y1; ++y) {
+		for (int z = 0; z < span; ++z) {
+			cur.moveTo(0, y, z);
+			for (int x = 0; x < span; ++x, cur.step(0, 1)) {
+				for (int axis = 0; axis < 3; ++axis) {
+					viaCursor += cur.peek(axis, 1) != voxel::BlockType::Air;
+					viaCursor += cur.peek(axis, -1) != voxel::BlockType::Air;
+				}
+			}
+		}
+	}
+	report("VoxelCursor (per voxel)", tc.elapsedNs() / voxels, -1, voxels);
+	if (viaLookup != viaCursor) {
+		std::printf("  MISMATCH: lookup=%lld cursor=%lld\n", viaLookup, viaCursor);
+		return 1;
+	}
+	g_sink = viaCursor;
+	return 0;
+}
+
+} // namespace bench
@@ -0,0 +1,61 @@
+#include "bench_util.hpp"
+#include "../config/config.hpp"
+#include "../voxel/world_manager.hpp"
+
+#include <cstdio>
+
+namespace bench {
+
+// Bulk region edits against the per-voxel setVoxel path. Each bulk op runs
+// on a fresh world so section creation is part of the cost, as it is for
+// an explosion or world-edit tool landing in unexplored space.
+int runEditBench() {
+	const config::Config& cfg = config::Config::instance();
+	const int y0 = cfg.world().min_section_y * cfg.chunk().sizeY;
+	const int y1 = (cfg.world().max_section_y + 1) * cfg.chunk().sizeY - 1;
+	const int span = 384;
+	const std::size_t boxVoxels = static_cast<std::size_t>(span) * span * (y1 - y0 + 1);
+	std::printf("edit bench: %dx%dx%d box (%zu voxels)\n", span, y1 - y0 + 1, span, boxVoxels);
+
+	{
+		voxel::World world;
+		voxel::WorldManager wm(world);
+		Timer t;
+		const int sections = wm.fillBox(0, y0, 0, span - 1, y1, span - 1, voxel::BlockType::Dirt);
+		report("fillBox (per voxel)", t.elapsedNs() / boxVoxels, -1, boxVoxels);
+
+		Timer tr;
+		wm.replaceInRegion(0, y0, 0, span - 1, y1, span - 1, voxel::BlockType::Dirt, voxel::BlockType::Air);
+		report("replaceInRegion (per voxel)", tr.elapsedNs() / boxVoxels, -1, boxVoxels);
+		std::printf("  sections touched per op: %d, edited sections reported: %zu\n", sections, wm.takeEditedSections().size());
+	}
+	{
+		voxel::World world;
+		voxel::WorldManager wm(world);
+		wm.fillBox(0, y0, 0, span - 1, y1, span - 1, voxel::BlockType::Dirt);
+		const int r = (y1 - y0) / 2;
+		const std::size_t sphereVoxels = static_cast<std::size_t>(4.19 * r * r * r);
+		Timer t;
+		wm.fillSphere(span / 2, (y0 + y1) / 2, span / 2, r, voxel::BlockType::Air);
+		report("fillSphere (per voxel)", t.elapsedNs() / sphereVoxels, -1, sphereVoxels);
+
+		const std::size_t copyVoxels = static_cast<std::size_t>(span / 2) * (span / 2) * (y1 - y0 + 1);
+		Timer tc;
+		wm.copyRegion(0, y0, 0, span / 2 - 1, y1, span / 2 - 1, span / 4, y0, span / 4);
+		report("copyRegion overlapping (per voxel)", tc.elapsedNs() / copyVoxels, -1, copyVoxels);
+	}
+	{
+		voxel::World world;
+		voxel::WorldManager wm(world);
+		wm.fillBox(0, y0, 0, span - 1, y1, span - 1, voxel::BlockType::Air);
+		const voxel::Voxel dirt{ voxel::BlockType::Dirt };
+		Timer t;
+		for (int y = y0; y <= y1; ++y)
+			for (int z = 0; z < span; ++z)
+				for (int x = 0; x < span; ++x) wm.setVoxel(x, y, z, dirt);
+		report("setVoxel loop (per voxel)", t.elapsedNs() / boxVoxels, -1, boxVoxels);
+	}
+	return 0;
+}
+
+} // namespace bench
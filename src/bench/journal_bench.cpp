@@ -0,0 +1,71 @@
+#include "bench_util.hpp"
+#include "../config/config.hpp"
+#include "../voxel/edit_journal.hpp"
+#include "../voxel/region_file.hpp"
+#include "../voxel/world_manager.hpp"
+
+#include <cstdio>
+#include <filesystem>
+#include <random>
+
+namespace bench {
+
+// Cost of making a frame's worth of scattered edits durable: one journal
+// sync against rewriting and syncing every dirty section. Each round edits
+// a few voxels across many sections, then persists them.
+int runJournalBench() {
+	const config::Config& cfg = config::Config::instance();
+	const std::string dir = (std::filesystem::temp_directory_path() / "voxel_journal_bench").string();
+	std::error_code ec;
+	std::filesystem::remove_all(dir, ec);
+	const int sx = cfg.chunk().sizeX, sy = cfg.chunk().sizeY;
+	const int half = 8 * sx;
+	const int y0 = cfg.world().min_section_y * sy;
+	const int rounds = 20, editsPerRound = 64;
+
+	auto measure = [&](const char* name, bool journaled) {
+		std::filesystem::remove_all(dir, ec);
+		voxel::EditJournal journal;
+		voxel::World world;
+		voxel::WorldManager wm(world);
+		wm.setSaveDirectory(dir);
+		wm.fillBox(-half, y0, -half, half - 1, y0 + sy - 1, half - 1, voxel::BlockType::Dirt);
+		wm.saveSections();
+		if (journaled) {
+			journal.open(dir + "/edits.vjl");
+			wm.setJournal(&journal);
+		}
+		std::mt19937 rng(3);
+		double total = 0.0;
+		for (int r = 0; r < rounds; ++r) {
+			for (int i = 0; i < editsPerRound; ++i) {
+				const int x = static_cast<int>(rng() % (2 * half)) - half;
+				const int z = static_cast<int>(rng() % (2 * half)) - half;
+				wm.setVoxel(x, y0 + static_cast<int>(rng() % sy), z, voxel::Voxel{ voxel::BlockType::Air });
+			}
+			Timer t;
+			if (journaled) {
+				journal.sync();
+			} else {
+				// Durable like the journal: the rewritten regions are synced too
+				wm.saveSections();
+				for (const auto& entry : std::filesystem::directory_iterator(dir, ec)) voxel::syncFile(entry.path().string());
+			}
+			total += t.elapsedNs();
+		}
+		report(std::string(name) + " (per round)", total / rounds, -1, rounds);
+		if (journaled) {
+			std::printf("  %-40s %12zu bytes\n", "journal size", journal.size());
+			Timer t;
+			const int written = wm.checkpoint();
+			report("checkpoint (" + std::to_string(written) + " sections)", t.elapsedNs(), -1, 1);
+		}
+	};
+	std::printf("journal bench: %d rounds of %d scattered edits\n", rounds, editsPerRound);
+	measure("saveSections + fsync", false);
+	measure("journal sync", true);
+	std::filesystem::remove_all(dir, ec);
+	return 0;
+}
+
+} // namespace bench
@@ -0,0 +1,78 @@
+#include "bench_util.hpp"
+#include "../mesh/greedy_mesher.hpp"
+#include "../render/raycast.hpp"
+
+#include <cstdio>
+#include <random>
+
+namespace bench {
+
+// Keeps benchmark results observable so the work is not optimized away
+static volatile long long g_sink = 0;
+
+// Compares voxel storage layouts on the three access patterns that care:
+// meshing, ray traversal, and a 6-neighbour sweep (lighting-style).
+int runLayoutBench(int size) {
+	const voxel::ChunkLayout layouts[] = { voxel::ChunkLayout::Linear, voxel::ChunkLayout::Morton, voxel::ChunkLayout::Bricked4 };
+	const auto corpus = makeCorpus(size, size, size);
+	CacheMissCounter counter;
+	std::printf("layout bench: %dx%dx%d chunks%s\n", size, size, size, counter.available() ? "" : " (cache-miss counters unavailable)");
+
+	// Fixed ray set so every layout traverses identical paths
+	struct Ray { float o[3]; float d[3]; };
+	std::vector<Ray> rays(4096);
+	std::mt19937 rng(42);
+	std::uniform_real_distribution<float> pos(0.0f, static_cast<float>(size));
+	std::uniform_real_distribution<float> dir(-1.0f, 1.0f);
+	for (Ray& r : rays) {
+		r = Ray{ { pos(rng), pos(rng), pos(rng) }, { dir(rng), dir(rng), dir(rng) } };
+	}
+
+	for (const CorpusChunk& entry : corpus) {
+		std::printf("%s\n", entry.name.c_str());
+		for (voxel::ChunkLayout layout : layouts) {
+			voxel::Chunk chunk(size, size, size, voxel::BlockType::Air, layout);
+			if (chunk.layout() != layout) continue;
+			fillChunk(chunk, entry.types);
+			const std::string tag = std::string(voxel::toString(layout));
+
+			mesh::GreedyMesher mesher;
+			const int meshReps = 20;
+			counter.start();
+			Timer tm;
+			std::size_t quads = 0;
+			for (int i = 0; i < meshReps; ++i) quads += mesher.buildMesh(chunk).vertices.size();
+			double ns = tm.elapsedNs();
+			report(tag + " GreedyMesher::buildMesh", ns / meshReps, counter.stop(), meshReps);
+
+			counter.start();
+			Timer tr;
+			int hits = 0;
+			for (const Ray& r : rays) {
+				hits += render::raycastVoxel(chunk, r.o[0], r.o[1], r.o[2], r.d[0], r.d[1], r.d[2], static_cast<float>(size) * 2.0f).hit ? 1 : 0;
+			}
+			ns = tr.elapsedNs();
+			report(tag + " raycastVoxel", ns / rays.size(), counter.stop(), rays.size());
+
+			counter.start();
+			Timer tn;
+			long long solidNeighbours = 0;
+			chunk.forEachVoxel([&](int x, int y, int z, voxel::BlockType) {
+				if (x > 0) solidNeighbours += chunk.get(x - 1, y, z) != voxel::BlockType::Air;
+				if (x + 1 < size) solidNeighbours += chunk.get(x + 1, y, z) != voxel::BlockType::Air;
+				if (y > 0) solidNeighbours += chunk.get(x, y - 1, z) != voxel::BlockType::Air;
+				if (y + 1 < size) solidNeighbours += chunk.get(x, y + 1, z) != voxel::BlockType::Air;
+				if (z > 0) solidNeighbours += chunk.get(x, y, z - 1) != voxel::BlockType::Air;
+				if (z + 1 < size) solidNeighbours += chunk.get(x, y, z + 1) != voxel::BlockType::Air;
+			});
+			ns = tn.elapsedNs();
+			const std::size_t voxels = static_cast<std::size_t>(size) * size * size;
+			report(tag + " 6-neighbour sweep (per voxel)", ns / voxels, counter.stop(), voxels);
+
+			g_sink = static_cast<long long>(quads) + hits + solidNeighbours;
+		}
+	}
+	return 0;
+}
+
+} // namespace bench
@@ -0,0 +1,94 @@
+#include "bench_util.hpp"
+#include "../config/config.hpp"
+#include "../voxel/region_file.hpp"
+#include "../voxel/world_manager.hpp"
+#include "../voxel/world_reader.hpp"
+
+#include <cstdio>
+#include <filesystem>
+#include <memory>
+#include <random>
+#include <unordered_map>
+
+namespace bench {
+
+// Keeps benchmark results observable so the work is not optimized away
+static volatile long long g_sink = 0;
+
+// Reading saved sections through WorldReader's mapped regions against the
+// buffered path (RegionFile::read, then decode from the copy)
+int runReaderBench() {
+	const config::Config& cfg = config::Config::instance();
+	const std::string dir = (std::filesystem::temp_directory_path() / "voxel_reader_bench").string();
+	std::error_code ec;
+	std::filesystem::remove_all(dir, ec);
+	const int sx = cfg.chunk().sizeX, sy = cfg.chunk().sizeY, sz = cfg.chunk().sizeZ;
+	const int sections = 64;
+	const int y0 = cfg.world().min_section_y * sy;
+	{
+		voxel::World world;
+		voxel::WorldManager wm(world);
+		wm.setSaveDirectory(dir);
+		const int half = sections * sx / 2;
+		wm.fillBox(-half, y0, -half, half - 1, y0 + sy - 1, half - 1, voxel::BlockType::Dirt);
+		std::mt19937 rng(7);
+		for (int i = 0; i < sections * sections * 16; ++i) {
+			const int x = static_cast<int>(rng() % (2 * half)) - half;
+			const int z = static_cast<int>(rng() % (2 * half)) - half;
+			wm.setVoxel(x, y0 + static_cast<int>(rng() % sy), z, voxel::Voxel{ voxel::BlockType::Air });
+		}
+		std::printf("reader bench: %d sections saved\n", wm.saveSections());
+	}
+	const int c0 = -sections / 2, cy = cfg.world().min_section_y;
+	const std::size_t count = static_cast<std::size_t>(sections) * sections;
+
+	long long sum = 0;
+	{
+		std::vector<std::uint8_t> bytes;
+		voxel::Chunk chunk(sx, sy, sz);
+		std::unordered_map<std::uint64_t, std::unique_ptr<voxel::RegionFile>> files;
+		Timer t;
+		for (int cz = c0; cz < c0 + sections; ++cz) {
+			for (int cx = c0; cx < c0 + sections; ++cx) {
+				auto& f = files[voxel::packChunkKey(voxel::regionCoord(cx), cy, voxel::regionCoord(cz))];
+				if (!f) {
+					f = std::make_unique<voxel::RegionFile>();
+					f->open(voxel::regionFilePath(dir, cx, cy, cz), false);
+				}
+				if (f->read(voxel::regionLocal(cx), voxel::regionLocal(cz), bytes)) sum += chunk.loadFromBuffer(bytes.data(), bytes.size());
+			}
+		}
+		report("RegionFile read + decode (per section)", t.elapsedNs() / count, -1, count);
+	}
+	{
+		voxel::WorldReader reader(dir);
+		voxel::Chunk chunk(sx, sy, sz);
+		Timer t;
+		for (int cz = c0; cz < c0 + sections; ++cz) {
+			for (int cx = c0; cx < c0 + sections; ++cx) sum += reader.readSection(cx, cy, cz, chunk);
+		}
+		report("WorldReader readSection (per section)", t.elapsedNs() / count, -1, count);
+		std::printf("  %-40s %12zu (%zu KB mapped)\n", "regions mapped", reader.mappedRegions(), reader.mappedBytes() >> 10);
+
+		// Scattered lookups decode a section each; a walk along x mostly
+		// stays within the cached one
+		const int lookups = 20000;
+		std::mt19937 rng(11);
+		const int half = sections * sx / 2;
+		Timer tr;
+		for (int i = 0; i < lookups; ++i) {
+			const int x = static_cast<int>(rng() % (2 * half)) - half;
+			const int z = static_cast<int>(rng() % (2 * half)) - half;
+			sum += static_cast<long long>(reader.blockAt(x, y0 + static_cast<int>(rng() % sy), z));
+		}
+		report("WorldReader blockAt, scattered", tr.elapsedNs() / lookups, -1, lookups);
+		Timer tw;
+		for (int i = 0; i < lookups; ++i) sum += static_cast<long long>(reader.blockAt(i % (2 * half) - half, y0, 0));
+		report("WorldReader blockAt, walk", tw.elapsedNs() / lookups, -1, lookups);
+	}
+	g_sink = sum;
+	std::filesystem::remove_all(dir, ec);
+	return 0;
+}
+
+} // namespace bench
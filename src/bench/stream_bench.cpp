@@ -0,0 +1,66 @@
+#include "bench_util.hpp"
+#include "../config/config.hpp"
+#include "../voxel/chunk_io_service.hpp"
+#include "../voxel/world_manager.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+
+namespace bench {
+
+// Per-update cost of walking across a saved world, loading sections
+// synchronously and through ChunkIoService. Reports the first update (the
+// whole view at once), then the mean and worst update of the walk; the
+// worst is the one that shows up as a frame hitch.
+int runStreamBench() {
+	const config::Config& cfg = config::Config::instance();
+	const std::string dir = (std::filesystem::temp_directory_path() / "voxel_stream_bench").string();
+	std::error_code ec;
+	std::filesystem::remove_all(dir, ec);
+	const int span = 96 * cfg.chunk().sizeX;
+	const int y0 = cfg.world().min_section_y * cfg.chunk().sizeY;
+	{
+		voxel::World world;
+		voxel::WorldManager wm(world);
+		wm.setSaveDirectory(dir);
+		wm.fillBox(-span / 2, y0, -span / 2, span / 2, y0 + cfg.chunk().sizeY * 2 - 1, span / 2, voxel::BlockType::Dirt);
+		wm.setVoxel(0, y0, 0, voxel::Voxel{ voxel::BlockType::Air });
+		std::printf("stream bench: %d sections saved, walking %d voxels\n", wm.saveSections(), span);
+	}
+
+	auto walk = [&](const char* name, voxel::ChunkIoService* io) {
+		voxel::World world;
+		voxel::WorldManager wm(world);
+		wm.setSaveDirectory(dir);
+		wm.setIoService(io);
+		wm.setViewDistance(8);
+		// The first update streams in the whole view at once; the walk after
+		// it brings in one slice of sections per section crossed
+		Timer tf;
+		wm.updatePlayerPosition(static_cast<float>(-span / 4), static_cast<float>(y0), 0.0f);
+		report(std::string(name) + " first updatePlayerPosition", tf.elapsedNs(), -1, 1);
+		const int steps = span / 2;
+		double total = 0.0, worst = 0.0;
+		for (int i = 1; i <= steps; ++i) {
+			const float x = static_cast<float>(-span / 4 + i);
+			Timer t;
+			wm.updatePlayerPosition(x, static_cast<float>(y0), 0.0f);
+			const double ns = t.elapsedNs();
+			total += ns;
+			worst = std::max(worst, ns);
+		}
+		report(std::string(name) + " updatePlayerPosition (mean)", total / steps, -1, steps);
+		report(std::string(name) + " updatePlayerPosition (worst)", worst, -1, 1);
+		std::printf("  %-40s %12zu\n", "sections resident", world.chunkCount());
+	};
+	walk("sync", nullptr);
+	{
+		voxel::ChunkIoService io(dir);
+		walk("async", &io);
+	}
+	std::filesystem::remove_all(dir, ec);
+	return 0;
+}
+
+} // namespace bench
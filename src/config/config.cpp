@@ -23,6 +23,7 @@ bool Config::loadFromFile(const std::string& path) {
         if (key == "chunk.size_x") chunk_.sizeX = std::stoi(val);
         else if (key == "chunk.size_y") chunk_.sizeY = std::stoi(val);
         else if (key == "chunk.size_z") chunk_.sizeZ = std::stoi(val);
+        else if (key == "chunk.layout") chunk_.layout = val;
         else if (key == "logging.level") logging_.level = val;
         else if (key == "logging.file") logging_.filePath = val;
         else if (key == "graphics.vsync") graphics_.vsync = (val == "true" || val == "1");
@@ -35,6 +36,15 @@ bool Config::loadFromFile(const std::string& path) {
         else if (key == "ui.scale") ui_.scale = std::stof(val);
         else if (key == "ui.crosshair_enabled") ui_.crosshair_enabled = (val == "true" || val == "1");
         else if (key == "ui.crosshair_percent") ui_.crosshair_percent = std::stof(val);
+        else if (key == "world.min_section_y") world_.min_section_y = std::stoi(val);
+        else if (key == "world.max_section_y") world_.max_section_y = std::stoi(val);
+        else if (key == "world.vertical_view_distance") world_.vertical_view_distance = std::stoi(val);
+        else if (key == "world.unload_hysteresis") world_.unload_hysteresis = std::stoi(val);
+        else if (key == "world.memory_budget_mb") world_.memory_budget_mb = std::stoi(val);
+        else if (key == "world.storage_pool_mb") world_.storage_pool_mb = std::stoi(val);
+        else if (key == "world.cold_after_moves") world_.cold_after_moves = std::stoi(val);
+        else if (key == "world.journal_sync_ms") world_.journal_sync_ms = std::stoi(val);
+        else if (key == "world.journal_checkpoint_kb") world_.journal_checkpoint_kb = std::stoi(val);
         else if (key == "build.time") build_time_ = val;
     }
     return true;
@@ -8,6 +8,8 @@ struct ChunkDimensions {
 	int sizeX {16};
 	int sizeY {16};
 	int sizeZ {16};
+	// Voxel storage order: linear, morton or bricked
+	std::string layout {"linear"};
 };
 
 class Config {
@@ -47,6 +49,31 @@ public:
 	const UI& ui() const { return ui_; }
 	UI& ui() { return ui_; }
 
+	// Vertical extent of the world in chunk sections, and how many
+	// sections above/below the player are kept streamed in
+	struct World {
+		int min_section_y {0};
+		int max_section_y {3};
+		int vertical_view_distance {2};
+		// Sections stay resident this many sections past the view distance
+		// before they are unloaded, so walking along a border does not thrash
+		int unload_hysteresis {1};
+		// Voxel storage budget; least recently used sections outside the
+		// view are evicted past it. 0 disables the budget.
+		int memory_budget_mb {256};
+		// Freed chunk buffers kept for reuse by the storage pool
+		int storage_pool_mb {32};
+		// Sections out of view for this many player section changes are
+		// kept compressed in memory until revisited. 0 keeps them all hot.
+		int cold_after_moves {2};
+		// Edit journal: staged edits are synced to disk at least this often,
+		// and checkpointed into region files once the journal reaches this size
+		int journal_sync_ms {50};
+		int journal_checkpoint_kb {4096};
+	};
+
+	const World& world() const { return world_; }
+
     // Build info
     const std::string& buildTime() const { return build_time_; }
     void setBuildTime(const std::string& t) { build_time_ = t; }
@@ -56,6 +83,7 @@ private:
 	Logging logging_{};
 	Graphics graphics_{};
 	UI ui_{};
+	World world_{};
     std::string build_time_{};
 };
 
@@ -0,0 +1,50 @@
+#include "crc32c.hpp"
+
+#include <array>
+
+namespace core {
+
+namespace {
+
+// Slicing-by-8 tables for the reflected polynomial 0x82F63B78: table[0]
+// is the classic byte table, table[k] advances a byte k positions further
+struct Crc32cTables {
+	std::array<std::array<std::uint32_t, 256>, 8> t{};
+	Crc32cTables() {
+		for (std::uint32_t i = 0; i < 256; ++i) {
+			std::uint32_t c = i;
+			for (int k = 0; k < 8; ++k) c = (c >> 1) ^ ((c & 1u) ? 0x82F63B78u : 0u);
+			t[0][i] = c;
+		}
+		for (std::uint32_t i = 0; i < 256; ++i) {
+			for (std::size_t k = 1; k < 8; ++k) t[k][i] = (t[k - 1][i] >> 8) ^ t[0][t[k - 1][i] & 0xFF];
+		}
+	}
+};
+
+const Crc32cTables& tables() {
+	static const Crc32cTables tables;
+	return tables;
+}
+
+} // namespace
+
+std::uint32_t crc32c(const void* data, std::size_t size, std::uint32_t crc) {
+	const auto& t = tables().t;
+	const unsigned char* p = static_cast<const unsigned char*>(data);
+	crc = ~crc;
+	// Eight bytes per step; the words are read little-endian byte by byte so
+	// the result does not depend on host byte order
+	while (size >= 8) {
+		const std::uint32_t lo = crc ^ (static_cast<std::uint32_t>(p[0]) | static_cast<std::uint32_t>(p[1]) << 8
+			| static_cast<std::uint32_t>(p[2]) << 16 | static_cast<std::uint32_t>(p[3]) << 24);
+		crc = t[7][lo & 0xFF] ^ t[6][(lo >> 8) & 0xFF] ^ t[5][(lo >> 16) & 0xFF] ^ t[4][lo >> 24]
+			^ t[3][p[4]] ^ t[2][p[5]] ^ t[1][p[6]] ^ t[0][p[7]];
+		p += 8;
+		size -= 8;
+	}
+	while (size--) crc = (crc >> 8) ^ t[0][(crc ^ *p++) & 0xFF];
+	return ~crc;
+}
+
+} // namespace core
@@ -0,0 +1,12 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace core {
+
+// CRC-32C (Castagnoli), as used by iSCSI, ext4 and most storage formats.
+// Pass a previous result as crc to checksum data in pieces.
+std::uint32_t crc32c(const void* data, std::size_t size, std::uint32_t crc = 0);
+
+} // namespace core
@@ -0,0 +1,10 @@
+#include "debug_counters.hpp"
+
+namespace core {
+
+DebugCounters& debugCounters() {
+	static DebugCounters counters;
+	return counters;
+}
+
+} // namespace core
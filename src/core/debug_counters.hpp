@@ -0,0 +1,32 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+namespace core {
+
+// Process-wide counters shown in the debug HUD. Subsystems write them,
+// the HUD only reads, so nothing above core needs to know about the other.
+struct DebugCounters {
+	std::atomic<std::uint64_t> residentChunks {0};
+	std::atomic<std::uint64_t> evictedChunks {0};
+	std::atomic<std::uint64_t> savedOnEvict {0};
+	std::atomic<std::uint64_t> residentVoxelBytes {0};
+	// Sections held compressed in the cold tier, and their encoded bytes
+	std::atomic<std::uint64_t> coldChunks {0};
+	std::atomic<std::uint64_t> coldVoxelBytes {0};
+	std::atomic<std::uint64_t> poolHits {0};
+	std::atomic<std::uint64_t> poolMisses {0};
+	// Chunk bodies cloned because a snapshot still held the old one
+	std::atomic<std::uint64_t> snapshotClones {0};
+	// Background chunk I/O: requests completed, the file reads the loads
+	// were coalesced into, and requests not yet finished
+	std::atomic<std::uint64_t> ioLoads {0};
+	std::atomic<std::uint64_t> ioSaves {0};
+	std::atomic<std::uint64_t> ioReads {0};
+	std::atomic<std::uint64_t> ioPending {0};
+};
+
+DebugCounters& debugCounters();
+
+} // namespace core
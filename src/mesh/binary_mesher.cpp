@@ -0,0 +1,165 @@
+#include "binary_mesher.hpp"
+#include "../voxel/chunk_dims.hpp"
+#include "../voxel/block_registry.hpp"
+#include <algorithm>
+#include <bit>
+
+namespace mesh {
+
+// Bits [0, w) set; w may be the full 64.
+static inline std::uint64_t lowBits(int w) {
+    return (w >= 64) ? ~0ull : ((1ull << w) - 1ull);
+}
+
+// Build the per-axis occupancy columns from the chunk's solid bits.
+// Column for axis d lives at index v*nu + u with u=(d+1)%3, v=(d+2)%3,
+// matching GreedyMesher's mask layout. X rows are read straight out of the
+// occupancy mask; only their set bits are scattered into the Y and Z columns.
+// Layers outside [yLo, yHi) are known empty and are not read.
+template<class Dims>
+static void buildColumns(const voxel::OccupancyMask& occ, std::vector<std::uint64_t> (&columns)[3], const Dims& dims, int yLo, int yHi) {
+    const int sx = dims.sizeX, sy = dims.sizeY, sz = dims.sizeZ;
+    columns[0].assign(static_cast<size_t>(sz) * sy, 0); // along X, u=y v=z
+    columns[1].assign(static_cast<size_t>(sx) * sz, 0); // along Y, u=z v=x
+    columns[2].assign(static_cast<size_t>(sy) * sx, 0); // along Z, u=x v=y
+    for (int y = yLo; y < yHi; ++y) {
+        for (int z = 0; z < sz; ++z) {
+            std::uint64_t row = occ.bits(dims.index(0, y, z), sx);
+            columns[0][static_cast<size_t>(z) * sy + y] = row;
+            while (row) {
+                const int x = std::countr_zero(row);
+                row &= row - 1;
+                columns[1][static_cast<size_t>(x) * sz + z] |= 1ull << y;
+                columns[2][static_cast<size_t>(y) * sx + x] |= 1ull << z;
+            }
+        }
+    }
+}
+
+// Column culling treats every solid bit as opaque. That only holds when
+// each type in the palette is air or opaque; direct-mode storage has no
+// palette to check and is assumed to hold see-through blocks.
+static bool paletteAllOpaque(const voxel::PaletteStorage& storage) {
+    if (storage.paletteSize() == 0) return false;
+    const std::uint8_t* opaque = voxel::blockTables().opaque.data();
+    for (std::size_t i = 0; i < storage.paletteSize(); ++i) {
+        const voxel::BlockType t = storage.paletteEntry(i);
+        if (t != voxel::BlockType::Air && !opaque[static_cast<std::uint8_t>(t)]) return false;
+    }
+    return true;
+}
+
+template<int D, bool Positive, class Dims>
+static void meshFace(Mesh& out, MeshStats& stats, std::vector<std::uint64_t>& planes,
+    const std::vector<std::uint64_t>& cols, const voxel::BlockType* types, const Dims& dims)
+{
+    constexpr int U = (D + 1) % 3;
+    constexpr int V = (D + 2) % 3;
+    const int size[3] = { dims.sizeX, dims.sizeY, dims.sizeZ };
+    const int nu = size[U];
+    const int nv = size[V];
+    const int nd = size[D];
+    auto typeAt = [&](const int p[3]) -> voxel::BlockType {
+        return types[dims.index(p[0], p[1], p[2])];
+    };
+
+    // Cull whole columns at once (outside the chunk is air), then
+    // scatter the surviving face bits into per-slice row masks over u.
+    planes.assign(static_cast<size_t>(nd) * nv, 0);
+    for (int j = 0; j < nv; ++j) {
+        for (int i = 0; i < nu; ++i) {
+            const std::uint64_t col = cols[static_cast<size_t>(j) * nu + i];
+            std::uint64_t faces = Positive ? (col & ~(col >> 1)) : (col & ~(col << 1));
+            stats.exposedFaces += static_cast<size_t>(std::popcount(faces));
+            while (faces) {
+                const int s = std::countr_zero(faces);
+                faces &= faces - 1;
+                planes[static_cast<size_t>(s) * nv + j] |= 1ull << i;
+            }
+        }
+    }
+
+    // Greedy merge on the row masks. Runs of set bits are found with
+    // count-trailing-zeros; block types only break runs that are already
+    // contiguous, so same-type terrain merges without per-cell scans of air.
+    for (int slice = 0; slice < nd; ++slice) {
+        std::uint64_t* rows = &planes[static_cast<size_t>(slice) * nv];
+        const int plane = Positive ? slice + 1 : slice;
+        int p[3];
+        p[D] = slice;
+        for (int j = 0; j < nv; ++j) {
+            while (rows[j]) {
+                const int i = std::countr_zero(rows[j]);
+                p[U] = i; p[V] = j;
+                const voxel::BlockType t = typeAt(p);
+
+                const int run = std::countr_zero(~(rows[j] >> i));
+                const int maxW = std::min(run, nu - i);
+                int w = 1;
+                for (; w < maxW; ++w) {
+                    p[U] = i + w;
+                    if (typeAt(p) != t) break;
+                }
+                const std::uint64_t span = lowBits(w) << i;
+
+                int h = 1;
+                for (; j + h < nv; ++h) {
+                    if ((rows[j + h] & span) != span) break;
+                    p[V] = j + h;
+                    bool same = true;
+                    for (int k = 0; k < w; ++k) {
+                        p[U] = i + k;
+                        if (typeAt(p) != t) { same = false; break; }
+                    }
+                    if (!same) break;
+                }
+
+                for (int dj = 0; dj < h; ++dj) rows[j + dj] &= ~span;
+                appendFace(out, D, Positive, plane, i, j, i + w, j + h);
+                ++stats.quads;
+            }
+        }
+    }
+}
+
+Mesh BinaryMesher::buildMesh(const voxel::Chunk& chunk) {
+    const int dims[3] = { chunk.sizeX(), chunk.sizeY(), chunk.sizeZ() };
+    Mesh out;
+    stats_ = MeshStats{};
+    if (chunk.isUniform()) {
+        // Uniform chunks need no scan: nothing for air, the outer box otherwise
+        if (chunk.uniformType() != voxel::BlockType::Air) {
+            appendBox(out, dims[0], dims[1], dims[2]);
+            stats_.exposedFaces = 2 * (static_cast<size_t>(dims[0]) * dims[1]
+                + static_cast<size_t>(dims[1]) * dims[2] + static_cast<size_t>(dims[0]) * dims[2]);
+            stats_.quads = 6;
+        }
+        return out;
+    }
+    if (dims[0] > kMaxAxis || dims[1] > kMaxAxis || dims[2] > kMaxAxis || !paletteAllOpaque(chunk.storage())) {
+        out = fallback_.buildMesh(chunk);
+        stats_ = fallback_.lastStats();
+        return out;
+    }
+
+    const int yLo = chunk.minSolidY();
+    const int yHi = chunk.maxSolidY() + 1;
+    if (yLo < 0) return out;
+
+    types_.resize(static_cast<size_t>(dims[0]) * dims[1] * dims[2]);
+    chunk.copyTypes(types_.data());
+
+    // Six face directions in the order +X,-X,+Y,-Y,+Z,-Z
+    voxel::dispatchChunkDims(dims[0], dims[1], dims[2], [&](const auto& d) {
+        buildColumns(chunk.occupancy(), columns_, d, yLo, yHi);
+        meshFace<0, true>(out, stats_, planes_, columns_[0], types_.data(), d);
+        meshFace<0, false>(out, stats_, planes_, columns_[0], types_.data(), d);
+        meshFace<1, true>(out, stats_, planes_, columns_[1], types_.data(), d);
+        meshFace<1, false>(out, stats_, planes_, columns_[1], types_.data(), d);
+        meshFace<2, true>(out, stats_, planes_, columns_[2], types_.data(), d);
+        meshFace<2, false>(out, stats_, planes_, columns_[2], types_.data(), d);
+    });
+    return out;
+}
+
+} // namespace mesh
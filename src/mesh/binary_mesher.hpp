@@ -0,0 +1,34 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include "../voxel/chunk.hpp"
+#include "../voxel/voxel.hpp"
+#include "greedy_mesher.hpp"
+#include "mesh.hpp"
+
+namespace mesh {
+
+// Mesher that culls faces on whole 64-bit occupancy columns instead of
+// testing neighbours voxel by voxel. Emits exactly the same quads, in the
+// same order, as GreedyMesher so the two can be swapped and compared.
+// Chunks with an axis longer than kMaxAxis, or holding blocks that are not
+// opaque, fall back to GreedyMesher.
+class BinaryMesher {
+public:
+	static constexpr int kMaxAxis = 64;
+
+	Mesh buildMesh(const voxel::Chunk& chunk);
+
+	const MeshStats& lastStats() const { return stats_; }
+
+private:
+	MeshStats stats_{};
+	GreedyMesher fallback_;
+	// Scratch buffers reused between calls
+	std::vector<voxel::BlockType> types_;
+	std::vector<std::uint64_t> columns_[3];
+	std::vector<std::uint64_t> planes_;
+};
+
+} // namespace mesh
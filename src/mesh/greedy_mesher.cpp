@@ -2,109 +2,146 @@
 #include "mesh.hpp"
 #include "../voxel/chunk.hpp"
 #include "../voxel/voxel.hpp"
+#include "../voxel/chunk_dims.hpp"
+#include "../voxel/block_registry.hpp"
+#include <vector>
 
 namespace mesh {
 
-static inline bool isSolid(const voxel::Voxel& v) {
-    return v.type != voxel::BlockType::Air;
-}
-
-// Emit a single quad into the mesh (two triangles)
-static void emitQuad(Mesh& out,
-    float x0, float y0, float z0,
-    float x1, float y1, float z1,
-    float x2, float y2, float z2,
-    float x3, float y3, float z3,
-    float nx, float ny, float nz)
+// Sweep one face direction (axis D, sign Positive): for each slice along D,
+// build a mask of exposed faces keyed by block type, then merge equal-type
+// cells into maximal rectangles. With FixedChunkDims every bound and index
+// below is a compile-time constant or shift. Only layers [yLo, yHi) hold
+// solid voxels; slices and mask rows outside them are skipped.
+// A non-air voxel shows a face unless its neighbour is opaque (a lookup in
+// the registry's opacity table) or the same block, so glass and water hide
+// their inner faces but not what is behind them.
+template<int D, bool Positive, class Dims>
+static void sweepFace(Mesh& out, MeshStats& stats, std::vector<voxel::BlockType>& mask,
+    const voxel::BlockType* types, const std::uint8_t* opaque, const Dims& dims, int yLo, int yHi)
 {
-    std::uint32_t base = static_cast<std::uint32_t>(out.vertices.size());
-    out.vertices.push_back(Vertex{ x0, y0, z0, nx, ny, nz, 0.0f, 0.0f });
-    out.vertices.push_back(Vertex{ x1, y1, z1, nx, ny, nz, 1.0f, 0.0f });
-    out.vertices.push_back(Vertex{ x2, y2, z2, nx, ny, nz, 1.0f, 1.0f });
-    out.vertices.push_back(Vertex{ x3, y3, z3, nx, ny, nz, 0.0f, 1.0f });
-    // Winding: counter-clockwise as seen from normal direction
-    out.indices.push_back(base + 0);
-    out.indices.push_back(base + 1);
-    out.indices.push_back(base + 2);
-    out.indices.push_back(base + 0);
-    out.indices.push_back(base + 2);
-    out.indices.push_back(base + 3);
-}
+    constexpr int U = (D + 1) % 3;
+    constexpr int V = (D + 2) % 3;
+    const int size[3] = { dims.sizeX, dims.sizeY, dims.sizeZ };
+    const int nu = size[U];
+    const int nv = size[V];
+    const int lo[3] = { 0, yLo, 0 };
+    const int hi[3] = { dims.sizeX, yHi, dims.sizeZ };
+    mask.assign(static_cast<size_t>(nu) * nv, voxel::BlockType::Air);
 
-Mesh GreedyMesher::buildMesh(const voxel::Chunk& chunk) {
-    Mesh out;
-    const int sx = chunk.sizeX();
-    const int sy = chunk.sizeY();
-    const int sz = chunk.sizeZ();
-
-    auto solidAt = [&](int x, int y, int z) -> bool {
-        if (x < 0 || y < 0 || z < 0 || x >= sx || y >= sy || z >= sz) return false; // outside is air
-        return isSolid(chunk.at(x,y,z));
-    };
-
-    // For each voxel, emit faces where neighbor is air
-    for (int z = 0; z < sz; ++z) {
-        for (int y = 0; y < sy; ++y) {
-            for (int x = 0; x < sx; ++x) {
-                if (!solidAt(x,y,z)) continue;
-                // +X
-                if (!solidAt(x+1,y,z)) {
-                    emitQuad(out,
-                        x+1, y,   z,
-                        x+1, y,   z+1,
-                        x+1, y+1, z+1,
-                        x+1, y+1, z,
-                        1,0,0);
-                }
-                // -X
-                if (!solidAt(x-1,y,z)) {
-                    emitQuad(out,
-                        x, y,   z,
-                        x, y+1, z,
-                        x, y+1, z+1,
-                        x, y,   z+1,
-                        -1,0,0);
-                }
-                // +Y
-                if (!solidAt(x,y+1,z)) {
-                    emitQuad(out,
-                        x,   y+1, z,
-                        x+1, y+1, z,
-                        x+1, y+1, z+1,
-                        x,   y+1, z+1,
-                        0,1,0);
-                }
-                // -Y
-                if (!solidAt(x,y-1,z)) {
-                    emitQuad(out,
-                        x,   y, z,
-                        x,   y, z+1,
-                        x+1, y, z+1,
-                        x+1, y, z,
-                        0,-1,0);
-                }
-                // +Z
-                if (!solidAt(x,y,z+1)) {
-                    emitQuad(out,
-                        x,   y,   z+1,
-                        x,   y+1, z+1,
-                        x+1, y+1, z+1,
-                        x+1, y,   z+1,
-                        0,0,1);
+    for (int slice = lo[D]; slice < hi[D]; ++slice) {
+        // Build face mask for this slice; outside the chunk is air
+        const int next = slice + (Positive ? 1 : -1);
+        const bool nextInside = next >= 0 && next < size[D];
+        int p[3];
+        int q[3];
+        p[D] = slice;
+        q[D] = next;
+        for (int j = lo[V]; j < hi[V]; ++j) {
+            p[V] = j; q[V] = j;
+            for (int i = lo[U]; i < hi[U]; ++i) {
+                p[U] = i; q[U] = i;
+                const voxel::BlockType t = types[dims.index(p[0], p[1], p[2])];
+                const voxel::BlockType n = nextInside ? types[dims.index(q[0], q[1], q[2])] : voxel::BlockType::Air;
+                const bool exposed = t != voxel::BlockType::Air && !opaque[static_cast<std::uint8_t>(n)] && n != t;
+                mask[static_cast<size_t>(j) * nu + i] = exposed ? t : voxel::BlockType::Air;
+                if (exposed) ++stats.exposedFaces;
+            }
+        }
+
+        // Merge runs: widen along u, then grow along v while the whole row matches
+        const int plane = Positive ? slice + 1 : slice;
+        for (int j = lo[V]; j < hi[V]; ++j) {
+            for (int i = lo[U]; i < hi[U]; ) {
+                const voxel::BlockType t = mask[static_cast<size_t>(j) * nu + i];
+                if (t == voxel::BlockType::Air) { ++i; continue; }
+                int w = 1;
+                while (i + w < hi[U] && mask[static_cast<size_t>(j) * nu + i + w] == t) ++w;
+                int h = 1;
+                for (; j + h < hi[V]; ++h) {
+                    const voxel::BlockType* row = &mask[static_cast<size_t>(j + h) * nu + i];
+                    bool same = true;
+                    for (int k = 0; k < w; ++k) {
+                        if (row[k] != t) { same = false; break; }
+                    }
+                    if (!same) break;
                 }
-                // -Z
-                if (!solidAt(x,y,z-1)) {
-                    emitQuad(out,
-                        x,   y,   z,
-                        x+1, y,   z,
-                        x+1, y+1, z,
-                        x,   y+1, z,
-                        0,0,-1);
+                appendFace(out, D, Positive, plane, i, j, i + w, j + h);
+                ++stats.quads;
+                for (int dj = 0; dj < h; ++dj) {
+                    voxel::BlockType* row = &mask[static_cast<size_t>(j + dj) * nu + i];
+                    for (int k = 0; k < w; ++k) row[k] = voxel::BlockType::Air;
                 }
+                i += w;
             }
         }
     }
+}
+
+void GreedyMesher::meshUniform(Mesh& out, voxel::BlockType t, int sizeX, int sizeY, int sizeZ) {
+    // Uniform chunks need no scan: nothing for air, the outer box otherwise
+    if (t == voxel::BlockType::Air) return;
+    appendBox(out, sizeX, sizeY, sizeZ);
+    stats_.exposedFaces = 2 * (static_cast<size_t>(sizeX) * sizeY
+        + static_cast<size_t>(sizeY) * sizeZ + static_cast<size_t>(sizeX) * sizeZ);
+    stats_.quads = 6;
+}
+
+void GreedyMesher::sweepTypes(Mesh& out, int sizeX, int sizeY, int sizeZ, int yLo, int yHi) {
+    const std::uint8_t* opaque = voxel::blockTables().opaque.data();
+
+    // Six face directions in the order +X,-X,+Y,-Y,+Z,-Z
+    voxel::dispatchChunkDims(sizeX, sizeY, sizeZ, [&](const auto& d) {
+        sweepFace<0, true>(out, stats_, mask_, types_.data(), opaque, d, yLo, yHi);
+        sweepFace<0, false>(out, stats_, mask_, types_.data(), opaque, d, yLo, yHi);
+        sweepFace<1, true>(out, stats_, mask_, types_.data(), opaque, d, yLo, yHi);
+        sweepFace<1, false>(out, stats_, mask_, types_.data(), opaque, d, yLo, yHi);
+        sweepFace<2, true>(out, stats_, mask_, types_.data(), opaque, d, yLo, yHi);
+        sweepFace<2, false>(out, stats_, mask_, types_.data(), opaque, d, yLo, yHi);
+    });
+}
+
+Mesh GreedyMesher::buildMesh(const voxel::Chunk& chunk) {
+    Mesh out;
+    stats_ = MeshStats{};
+    const int dims[3] = { chunk.sizeX(), chunk.sizeY(), chunk.sizeZ() };
+
+    if (chunk.isUniform()) {
+        meshUniform(out, chunk.uniformType(), dims[0], dims[1], dims[2]);
+        return out;
+    }
+
+    // Layers outside the chunk's solid Y range cannot expose faces
+    const int yLo = chunk.minSolidY();
+    const int yHi = chunk.maxSolidY() + 1;
+    if (yLo < 0) return out;
+
+    // Unpack the palette once, then mesh from the flat type array
+    types_.resize(static_cast<size_t>(dims[0]) * dims[1] * dims[2]);
+    chunk.copyTypes(types_.data());
+    sweepTypes(out, dims[0], dims[1], dims[2], yLo, yHi);
+    return out;
+}
+
+Mesh GreedyMesher::buildMesh(const voxel::ColumnRleStorage& columns) {
+    Mesh out;
+    stats_ = MeshStats{};
+    const int dims[3] = { columns.sizeX(), columns.sizeY(), columns.sizeZ() };
+
+    if (columns.isUniform()) {
+        meshUniform(out, columns.uniformType(), dims[0], dims[1], dims[2]);
+        return out;
+    }
+
+    // The solid Y range comes from each column's first and last runs
+    const int yLo = columns.minSolidY();
+    const int yHi = columns.maxSolidY() + 1;
+    if (yLo < 0) return out;
+
+    types_.resize(static_cast<size_t>(dims[0]) * dims[1] * dims[2]);
+    columns.copyTypes(types_.data());
+    sweepTypes(out, dims[0], dims[1], dims[2], yLo, yHi);
     return out;
 }
 
-} // namespace mesh
\ No newline at end of file
+} // namespace mesh
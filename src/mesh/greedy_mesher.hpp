@@ -1,15 +1,39 @@
 #pragma once
 
+#include <cstddef>
+#include <vector>
 #include "../voxel/chunk.hpp"
+#include "../voxel/column_rle_storage.hpp"
+#include "../voxel/voxel.hpp"
 #include "mesh.hpp"
 
 namespace mesh {
 
+// Face counts gathered during the last buildMesh call.
+// exposedFaces is what a one-quad-per-face mesher would emit;
+// quads is what was emitted after merging.
+struct MeshStats {
+	std::size_t exposedFaces {0};
+	std::size_t quads {0};
+};
+
 class GreedyMesher {
 public:
 	Mesh buildMesh(const voxel::Chunk& chunk);
-};
+	// Same mesh from the column-run backend; runs unpack as whole spans
+	Mesh buildMesh(const voxel::ColumnRleStorage& columns);
 
-} // namespace mesh
+	const MeshStats& lastStats() const { return stats_; }
 
+private:
+	MeshStats stats_{};
+	// Shared tail of both overloads: mesh types_ for Y range [yLo, yHi)
+	void sweepTypes(Mesh& out, int sizeX, int sizeY, int sizeZ, int yLo, int yHi);
+	void meshUniform(Mesh& out, voxel::BlockType t, int sizeX, int sizeY, int sizeZ);
 
+	// Scratch buffers reused between calls
+	std::vector<voxel::BlockType> types_;
+	std::vector<voxel::BlockType> mask_;
+};
+
+} // namespace mesh
@@ -1,8 +1,64 @@
 #include "mesh.hpp"
 
 namespace mesh {
-    // Mesh data structures implementation
-    // Implementation is minimal as this is just data containers
-} // namespace mesh
 
+// Emit a single quad into the mesh (two triangles).
+// UVs span the quad extent so textures tile across merged faces.
+static void emitQuad(Mesh& out,
+    float x0, float y0, float z0,
+    float x1, float y1, float z1,
+    float x2, float y2, float z2,
+    float x3, float y3, float z3,
+    float nx, float ny, float nz,
+    float du, float dv)
+{
+    std::uint32_t base = static_cast<std::uint32_t>(out.vertices.size());
+    out.vertices.push_back(Vertex{ x0, y0, z0, nx, ny, nz, 0.0f, 0.0f });
+    out.vertices.push_back(Vertex{ x1, y1, z1, nx, ny, nz, du,   0.0f });
+    out.vertices.push_back(Vertex{ x2, y2, z2, nx, ny, nz, du,   dv   });
+    out.vertices.push_back(Vertex{ x3, y3, z3, nx, ny, nz, 0.0f, dv   });
+    // Winding: counter-clockwise as seen from normal direction
+    out.indices.push_back(base + 0);
+    out.indices.push_back(base + 1);
+    out.indices.push_back(base + 2);
+    out.indices.push_back(base + 0);
+    out.indices.push_back(base + 2);
+    out.indices.push_back(base + 3);
+}
+
+// Corner order matches the original per-voxel quads for every direction.
+void appendFace(Mesh& out, int d, bool positive, int plane,
+    int u0, int v0, int u1, int v1)
+{
+    const int u = (d + 1) % 3;
+    const int v = (d + 2) % 3;
+    float c[4][3];
+    const int us[4] = { u0, positive ? u0 : u1, u1, positive ? u1 : u0 };
+    const int vs[4] = { v0, positive ? v1 : v0, v1, positive ? v0 : v1 };
+    for (int i = 0; i < 4; ++i) {
+        c[i][d] = static_cast<float>(plane);
+        c[i][u] = static_cast<float>(us[i]);
+        c[i][v] = static_cast<float>(vs[i]);
+    }
+    float n[3] = { 0.0f, 0.0f, 0.0f };
+    n[d] = positive ? 1.0f : -1.0f;
+    emitQuad(out,
+        c[0][0], c[0][1], c[0][2],
+        c[1][0], c[1][1], c[1][2],
+        c[2][0], c[2][1], c[2][2],
+        c[3][0], c[3][1], c[3][2],
+        n[0], n[1], n[2],
+        static_cast<float>(positive ? v1 - v0 : u1 - u0),
+        static_cast<float>(positive ? u1 - u0 : v1 - v0));
+}
 
+void appendBox(Mesh& out, int sx, int sy, int sz) {
+    const int dims[3] = { sx, sy, sz };
+    for (int face = 0; face < 6; ++face) {
+        const int d = face / 2;
+        const bool positive = (face % 2) == 0;
+        appendFace(out, d, positive, positive ? dims[d] : 0, 0, 0, dims[(d + 1) % 3], dims[(d + 2) % 3]);
+    }
+}
+
+} // namespace mesh
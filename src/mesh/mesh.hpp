@@ -16,6 +16,14 @@ struct Mesh {
 	std::vector<std::uint32_t> indices;
 };
 
-} // namespace mesh
+// Append a quad lying in the plane axis[d] == plane (d: 0=X, 1=Y, 2=Z),
+// covering [u0,u1) x [v0,v1) on the remaining axes u=(d+1)%3, v=(d+2)%3.
+// Shared by all meshers so their output is directly comparable.
+void appendFace(Mesh& out, int d, bool positive, int plane,
+	int u0, int v0, int u1, int v1);
 
+// Append the six outward faces of the box [0,sx) x [0,sy) x [0,sz) in mesher
+// order (+X,-X,+Y,-Y,+Z,-Z). Used for chunks filled with one solid block.
+void appendBox(Mesh& out, int sx, int sy, int sz);
 
+} // namespace mesh
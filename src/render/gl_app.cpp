@@ -17,6 +17,7 @@
 #include <cstring>
 #include <iostream>
 #include "../voxel/world.hpp"
+#include "../voxel/world_manager.hpp"
 #include "../mesh/greedy_mesher.hpp"
 #include <filesystem>
 #include <fstream>
@@ -84,7 +85,7 @@ static void writeRunError(const std::string& message) {
     std::fprintf(stderr, "%s\n", message.c_str());
 }
 
-int run_demo(voxel::World& world, mesh::GreedyMesher& mesher) {
+int run_demo(voxel::World& world, voxel::WorldManager& manager, mesh::GreedyMesher& mesher) {
 	if (!glfwInit()) {
 		core::log(core::LogLevel::Error, "Failed to init GLFW");
 		const char* disp = std::getenv("DISPLAY");
@@ -184,8 +185,10 @@ int run_demo(voxel::World& world, mesh::GreedyMesher& mesher) {
     glfwSetWindowAttrib(window, GLFW_RESIZABLE, GLFW_FALSE);
 
     // Build initial mesh from chunk (0,0)
-    voxel::Chunk& chunk = world.getOrCreateChunk(0,0);
+    voxel::Chunk& chunk = world.getOrCreateChunk(0,0,0);
     mesh::Mesh mesh = mesher.buildMesh(chunk);
+    // Edits go through the manager (journal, save tracking) and are
+    // remeshed once at the end of the frame
 
     bool showDebug = false;
     // FPS tracking
@@ -332,12 +335,10 @@ int run_demo(voxel::World& world, mesh::GreedyMesher& mesher) {
         RayHit hit = raycastVoxel(chunk, camX, camY, camZ, fwdX, fwdY, fwdZ, 100.0f);
         if ((pressL || pressR) && !isPaused) {
             if (pressL && hit.hit) {
-                int nonAir = 0;
-                for (int z=0; z<chunk.sizeZ(); ++z) for (int y=0; y<chunk.sizeY(); ++y) for (int x=0; x<chunk.sizeX(); ++x) if (chunk.at(x,y,z).type!=voxel::BlockType::Air) ++nonAir;
+                const size_t nonAir = chunk.solidCount();
                 // Protect world origin block (0,0,0) from deletion
                 if (nonAir > 1 && !(hit.x==0 && hit.y==0 && hit.z==0)) {
-                    chunk.at(hit.x,hit.y,hit.z).type = voxel::BlockType::Air;
-                    mesh = mesher.buildMesh(chunk);
+                    manager.setVoxel(hit.x, hit.y, hit.z, voxel::Voxel{ voxel::BlockType::Air });
                     int cx = 0, cz = 0;
                     core::log(core::LogLevel::Info, "Break block at (" + std::to_string(hit.x) + "," + std::to_string(hit.y) + "," + std::to_string(hit.z) + ") in chunk (" + std::to_string(cx) + "," + std::to_string(cz) + ")");
                 }
@@ -346,8 +347,7 @@ int run_demo(voxel::World& world, mesh::GreedyMesher& mesher) {
                 int py = hit.y + hit.ny;
                 int pz = hit.z + hit.nz;
                 if (px>=0&&py>=0&&pz>=0&&px<chunk.sizeX()&&py<chunk.sizeY()&&pz<chunk.sizeZ()) {
-                    chunk.at(px,py,pz).type = voxel::BlockType::Dirt;
-                    mesh = mesher.buildMesh(chunk);
+                    manager.setVoxel(px, py, pz, voxel::Voxel{ voxel::BlockType::Dirt });
                     int cx = 0, cz = 0;
                     core::log(core::LogLevel::Info, "Place block at (" + std::to_string(px) + "," + std::to_string(py) + "," + std::to_string(pz) + ") in chunk (" + std::to_string(cx) + "," + std::to_string(cz) + ")");
                 } else {
@@ -355,6 +355,13 @@ int run_demo(voxel::World& world, mesh::GreedyMesher& mesher) {
                 }
             }
         }
+        // Only chunk (0,0,0) is drawn; other edited sections have no mesh here
+        for (const voxel::SectionCoord& sc : manager.takeEditedSections()) {
+            if (sc == voxel::SectionCoord{0, 0, 0}) mesh = mesher.buildMesh(chunk);
+        }
+        // The demo does not stream, so the journal is synced here rather
+        // than by updatePlayerPosition
+        manager.syncJournal();
 
         // Highlight selection and placement preview
         if (hit.hit) {
@@ -1,14 +1,15 @@
 #pragma once
 
 #include "../mesh/mesh.hpp"
-namespace voxel { class World; }
+namespace voxel { class World; class WorldManager; }
 namespace mesh { class GreedyMesher; }
 
 namespace render {
 
 #ifdef VOXEL_WITH_GL
-// Run a minimal GL demo window to render and edit voxels in the provided world
-int run_demo(voxel::World& world, mesh::GreedyMesher& mesher);
+// Run a minimal GL demo window to render and edit voxels in the provided
+// world; edits go through the manager
+int run_demo(voxel::World& world, voxel::WorldManager& manager, mesh::GreedyMesher& mesher);
 #endif
 
 } // namespace render
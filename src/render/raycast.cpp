@@ -1,15 +1,21 @@
 #include "raycast.hpp"
 #include "../voxel/chunk.hpp"
 #include "../voxel/voxel.hpp"
+#include "../voxel/chunk_dims.hpp"
+#include "../voxel/block_registry.hpp"
 #include <cmath>
 
 namespace render {
 
-RayHit raycastVoxel(const voxel::Chunk& chunk, float ox, float oy, float oz, float dx, float dy, float dz, float maxDist) {
+// DDA traversal specialized on the chunk shape so bounds checks and voxel
+// indexing compile to constants and shifts for the prebuilt sizes.
+// solidAt(x, y, z) tests a voxel already known to be inside the chunk.
+template<class Dims, class SolidAt>
+static RayHit raycastImpl(const Dims& dims, SolidAt solidAt, float ox, float oy, float oz, float dx, float dy, float dz, float maxDist) {
     RayHit r{0,0,0,0,0,0,false};
-    const int sx = chunk.sizeX();
-    const int sy = chunk.sizeY();
-    const int sz = chunk.sizeZ();
+    const int sx = dims.sizeX;
+    const int sy = dims.sizeY;
+    const int sz = dims.sizeZ;
 
     int x = (int)std::floor(ox);
     int y = (int)std::floor(oy);
@@ -37,7 +43,7 @@ RayHit raycastVoxel(const voxel::Chunk& chunk, float ox, float oy, float oz, flo
     
     while (t < maxDist) {
         if (x >= 0 && y >= 0 && z >= 0 && x < sx && y < sy && z < sz) {
-            if (chunk.at(x, y, z).type != voxel::BlockType::Air) {
+            if (solidAt(x, y, z)) {
                 r.hit = true;
                 r.x = x; r.y = y; r.z = z;
                 // The normal should represent the face that was just crossed to enter this voxel
@@ -86,4 +92,18 @@ RayHit raycastVoxel(const voxel::Chunk& chunk, float ox, float oy, float oz, flo
     return r;
 }
 
+RayHit raycastVoxel(const voxel::Chunk& chunk, float ox, float oy, float oz, float dx, float dy, float dz, float maxDist) {
+    // Air is skipped on occupancy bits (linear order for every layout);
+    // only occupied voxels decode their type to check it is collidable
+    const voxel::OccupancyMask& occ = chunk.occupancy();
+    if (occ.allAir()) return RayHit{0,0,0,0,0,0,false};
+    const std::uint8_t* collidable = voxel::blockTables().collidable.data();
+    return voxel::dispatchChunkDims(chunk.sizeX(), chunk.sizeY(), chunk.sizeZ(), [&](const auto& dims) {
+        auto solidAt = [&](int x, int y, int z) {
+            return occ.test(dims.index(x, y, z)) && collidable[static_cast<std::uint8_t>(chunk.get(x, y, z))];
+        };
+        return raycastImpl(dims, solidAt, ox, oy, oz, dx, dy, dz, maxDist);
+    });
+}
+
 } // namespace render
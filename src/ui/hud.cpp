@@ -8,6 +8,7 @@
 
 #include "../input/input_manager.hpp"
 #include "../core/logging.hpp"
+#include "../core/debug_counters.hpp"
 #include "../config/config.hpp"
 
 namespace ui {
@@ -112,6 +113,20 @@ void HUD::renderDebugInfo() {
         ImGui::Text("ESC - Toggle Menu");
         ImGui::Text("F4 - Toggle Mouse Lock");
         ImGui::Text("F5 - Toggle VSync");
+        ImGui::Separator();
+        const core::DebugCounters& dc = core::debugCounters();
+        ImGui::Text("Chunks: %llu resident, %llu evicted (%llu saved)",
+            (unsigned long long)dc.residentChunks.load(), (unsigned long long)dc.evictedChunks.load(),
+            (unsigned long long)dc.savedOnEvict.load());
+        ImGui::Text("Voxel memory: %.1f MB", dc.residentVoxelBytes.load() / (1024.0 * 1024.0));
+        ImGui::Text("Cold tier: %llu chunks, %.1f MB",
+            (unsigned long long)dc.coldChunks.load(), dc.coldVoxelBytes.load() / (1024.0 * 1024.0));
+        ImGui::Text("Storage pool: %llu hits, %llu misses",
+            (unsigned long long)dc.poolHits.load(), (unsigned long long)dc.poolMisses.load());
+        ImGui::Text("Snapshot clones: %llu", (unsigned long long)dc.snapshotClones.load());
+        ImGui::Text("Chunk I/O: %llu loads in %llu reads, %llu saves, %llu pending",
+            (unsigned long long)dc.ioLoads.load(), (unsigned long long)dc.ioReads.load(),
+            (unsigned long long)dc.ioSaves.load(), (unsigned long long)dc.ioPending.load());
     }
     ImGui::End();
 #endif
@@ -0,0 +1,97 @@
+#include "block_registry.hpp"
+#include "../config/ini_parser.hpp"
+#include "../core/logging.hpp"
+#include <algorithm>
+#include <cstdlib>
+#include <map>
+
+namespace voxel {
+
+BlockRegistry& blockRegistry() {
+	static BlockRegistry registry;
+	return registry;
+}
+
+BlockRegistry::BlockRegistry() {
+	names_[0] = "air";
+	count_ = 1;
+	BlockProperties dirt;
+	dirt.name = "dirt";
+	dirt.opaque = true;
+	dirt.collidable = true;
+	dirt.lightOpacity = 15;
+	define(BlockType::Dirt, dirt);
+}
+
+bool BlockRegistry::define(BlockType id, const BlockProperties& props) {
+	const std::uint8_t i = static_cast<std::uint8_t>(id);
+	if (i == 0 || props.name.empty()) return false;
+	if (names_[i].empty()) ++count_;
+	names_[i] = props.name;
+	tables_.opaque[i] = props.opaque ? 1 : 0;
+	tables_.transparent[i] = props.transparent ? 1 : 0;
+	tables_.collidable[i] = props.collidable ? 1 : 0;
+	tables_.lightEmission[i] = props.lightEmission > 15 ? 15 : props.lightEmission;
+	tables_.lightOpacity[i] = props.lightOpacity > 15 ? 15 : props.lightOpacity;
+	return true;
+}
+
+bool BlockRegistry::findByName(const std::string& name, BlockType& out) const {
+	for (std::size_t i = 0; i < kMaxBlockTypes; ++i) {
+		if (names_[i] == name) {
+			out = static_cast<BlockType>(i);
+			return true;
+		}
+	}
+	return false;
+}
+
+static bool parseFlag(const std::string& v) { return v == "true" || v == "1" || v == "yes"; }
+
+// -1 when v is not an integer in [lo, hi]
+static long parseInt(const std::string& v, long lo, long hi) {
+	char* end = nullptr;
+	const long n = std::strtol(v.c_str(), &end, 10);
+	if (v.empty() || *end != '\0' || n < lo || n > hi) return -1;
+	return n;
+}
+
+bool BlockRegistry::loadFromFile(const std::string& path) {
+	config::IniParser parser;
+	if (!parser.parseFile(path)) return false;
+	// Gather the "blocks.<name>.<field>" entries of each block, then define them
+	struct Pending { BlockProperties props; long id {-1}; };
+	std::map<std::string, Pending> blocks;
+	static const std::string prefix = "blocks.";
+	for (const auto& [key, val] : parser.entries()) {
+		if (key.rfind(prefix, 0) != 0) continue;
+		const std::size_t dot = key.rfind('.');
+		if (dot == std::string::npos || dot <= prefix.size()) continue;
+		const std::string name = key.substr(prefix.size(), dot - prefix.size());
+		const std::string field = key.substr(dot + 1);
+		Pending& b = blocks[name];
+		b.props.name = name;
+		if (field == "id") b.id = parseInt(val, 1, kMaxBlockTypes - 1);
+		else if (field == "opaque") b.props.opaque = parseFlag(val);
+		else if (field == "transparent") b.props.transparent = parseFlag(val);
+		else if (field == "collidable") b.props.collidable = parseFlag(val);
+		else if (field == "light_emission") b.props.lightEmission = static_cast<std::uint8_t>(std::max(0L, parseInt(val, 0, 15)));
+		else if (field == "light_opacity") b.props.lightOpacity = static_cast<std::uint8_t>(std::max(0L, parseInt(val, 0, 15)));
+		else core::log(core::LogLevel::Warn, "blocks: unknown field '" + field + "' for block '" + name + "'");
+	}
+	for (const auto& [name, b] : blocks) {
+		if (b.id < 0) {
+			core::log(core::LogLevel::Warn, "blocks: '" + name + "' needs an id in 1..255; skipped");
+			continue;
+		}
+		const BlockType id = static_cast<BlockType>(b.id);
+		if (isDefined(id) && this->name(id) != name) {
+			core::log(core::LogLevel::Warn, "blocks: '" + name + "' reuses id " + std::to_string(b.id) + " of '" + this->name(id) + "'");
+		}
+		define(id, b.props);
+	}
+	core::log(core::LogLevel::Info, "Block registry: " + std::to_string(count_) + " block types from " + path);
+	return true;
+}
+
+} // namespace voxel
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include "voxel.hpp"
+
+namespace voxel {
+
+inline constexpr std::size_t kMaxBlockTypes = 256;
+
+// Properties of one block type as written in blocks.ini
+struct BlockProperties {
+	std::string name;
+	// Hides the faces of neighbours behind it
+	bool opaque {false};
+	// Drawn see-through (glass, water); its own faces stay visible
+	bool transparent {false};
+	// Stops rays and movement
+	bool collidable {false};
+	// Light emitted and absorbed, 0..15
+	std::uint8_t lightEmission {0};
+	std::uint8_t lightOpacity {0};
+};
+
+// Per-property lookup tables indexed by block id. Hot loops fetch the
+// table they need once and index it with the voxel's type: one load, no
+// branches on the block, no virtual calls or name lookups.
+struct BlockTables {
+	std::array<std::uint8_t, kMaxBlockTypes> opaque {};
+	std::array<std::uint8_t, kMaxBlockTypes> transparent {};
+	std::array<std::uint8_t, kMaxBlockTypes> collidable {};
+	std::array<std::uint8_t, kMaxBlockTypes> lightEmission {};
+	std::array<std::uint8_t, kMaxBlockTypes> lightOpacity {};
+};
+
+// Block definitions, loaded once at startup before any chunk is meshed.
+// Air (id 0) and dirt (id 1) are built in so the engine runs without a
+// blocks.ini; the file may redefine dirt and add ids up to 255.
+// Chunk occupancy still means "not air"; opacity and collision come from
+// here.
+class BlockRegistry {
+public:
+	BlockRegistry();
+
+	// Sections [blocks.<name>] with id, opaque, transparent, collidable,
+	// light_emission and light_opacity. Bad entries are logged and skipped;
+	// false only when the file cannot be read.
+	bool loadFromFile(const std::string& path);
+	// Define or replace one block; id 0 stays air
+	bool define(BlockType id, const BlockProperties& props);
+
+	const BlockTables& tables() const { return tables_; }
+	bool isDefined(BlockType id) const { return !names_[static_cast<std::uint8_t>(id)].empty(); }
+	const std::string& name(BlockType id) const { return names_[static_cast<std::uint8_t>(id)]; }
+	// Linear search by name; for startup and tools, not per-voxel code
+	bool findByName(const std::string& name, BlockType& out) const;
+	std::size_t count() const { return count_; }
+
+private:
+	BlockTables tables_ {};
+	std::array<std::string, kMaxBlockTypes> names_ {};
+	std::size_t count_ {0};
+};
+
+// Process-wide registry shared by meshers, raycasts and lighting
+BlockRegistry& blockRegistry();
+inline const BlockTables& blockTables() { return blockRegistry().tables(); }
+
+} // namespace voxel
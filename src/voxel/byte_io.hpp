@@ -0,0 +1,80 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace voxel {
+
+// Little-endian and LEB128 helpers shared by the chunk encoders and the
+// edit journal
+inline void putVarint(std::vector<std::uint8_t>& out, std::size_t v) {
+	while (v >= 0x80) {
+		out.push_back(static_cast<std::uint8_t>(v | 0x80));
+		v >>= 7;
+	}
+	out.push_back(static_cast<std::uint8_t>(v));
+}
+
+// Zigzag, so small negative values stay short
+inline void putSignedVarint(std::vector<std::uint8_t>& out, std::int64_t v) {
+	putVarint(out, static_cast<std::size_t>((static_cast<std::uint64_t>(v) << 1) ^ static_cast<std::uint64_t>(v >> 63)));
+}
+
+inline void putU16(std::vector<std::uint8_t>& out, int v) {
+	out.push_back(static_cast<std::uint8_t>(v & 0xFF));
+	out.push_back(static_cast<std::uint8_t>((v >> 8) & 0xFF));
+}
+
+inline void putU32(std::vector<std::uint8_t>& out, std::uint32_t v) {
+	for (int i = 0; i < 4; ++i) out.push_back(static_cast<std::uint8_t>(v >> (8 * i)));
+}
+
+// Overwrite four bytes in place, e.g. a size patched in after the fact
+inline void storeU32(std::uint8_t* p, std::uint32_t v) {
+	for (int i = 0; i < 4; ++i) p[i] = static_cast<std::uint8_t>(v >> (8 * i));
+}
+
+// Bounds-checked reader over encoded bytes
+struct ByteReader {
+	const std::uint8_t* p;
+	const std::uint8_t* end;
+
+	std::size_t remaining() const { return static_cast<std::size_t>(end - p); }
+	bool byte(std::uint8_t& v) {
+		if (p == end) return false;
+		v = *p++;
+		return true;
+	}
+	bool u16(int& v) {
+		std::uint8_t lo = 0, hi = 0;
+		if (!byte(lo) || !byte(hi)) return false;
+		v = lo | (hi << 8);
+		return true;
+	}
+	bool u32(std::uint32_t& v) {
+		if (remaining() < 4) return false;
+		v = static_cast<std::uint32_t>(p[0]) | static_cast<std::uint32_t>(p[1]) << 8
+			| static_cast<std::uint32_t>(p[2]) << 16 | static_cast<std::uint32_t>(p[3]) << 24;
+		p += 4;
+		return true;
+	}
+	bool varint(std::size_t& v) {
+		v = 0;
+		for (int shift = 0; shift < 64; shift += 7) {
+			std::uint8_t b = 0;
+			if (!byte(b)) return false;
+			v |= static_cast<std::size_t>(b & 0x7F) << shift;
+			if (!(b & 0x80)) return true;
+		}
+		return false;
+	}
+	bool signedVarint(std::int64_t& v) {
+		std::size_t u = 0;
+		if (!varint(u)) return false;
+		v = static_cast<std::int64_t>(u >> 1) ^ -static_cast<std::int64_t>(u & 1);
+		return true;
+	}
+};
+
+} // namespace voxel
@@ -0,0 +1,52 @@
+#include "channel_array.hpp"
+#include "storage_pool.hpp"
+#include <utility>
+
+namespace voxel {
+
+ChannelArray::ChannelArray(std::size_t count, int bits)
+	: count_(count), bits_(bits) {}
+
+ChannelArray::~ChannelArray() { clear(); }
+
+ChannelArray::ChannelArray(const ChannelArray& other)
+	: count_(other.count_), bits_(other.bits_), words_(storagePool().acquireCopy(other.words_)) {}
+
+ChannelArray::ChannelArray(ChannelArray&& other) noexcept
+	: count_(other.count_), bits_(other.bits_), words_(std::move(other.words_)) {
+	other.words_ = {};
+}
+
+ChannelArray& ChannelArray::operator=(const ChannelArray& other) {
+	if (this == &other) return *this;
+	ChannelArray copy(other);
+	return *this = std::move(copy);
+}
+
+ChannelArray& ChannelArray::operator=(ChannelArray&& other) noexcept {
+	if (this == &other) return *this;
+	clear();
+	count_ = other.count_;
+	bits_ = other.bits_;
+	words_ = std::move(other.words_);
+	other.words_ = {};
+	return *this;
+}
+
+void ChannelArray::set(std::size_t i, std::uint8_t v) {
+	if (words_.empty()) {
+		if (v == 0) return;
+		words_ = storagePool().acquire((count_ * static_cast<std::size_t>(bits_) + 63) / 64);
+	}
+	const std::size_t bit = i * static_cast<std::size_t>(bits_);
+	std::uint64_t& w = words_[bit >> 6];
+	const unsigned shift = static_cast<unsigned>(bit & 63);
+	w = (w & ~(mask() << shift)) | ((static_cast<std::uint64_t>(v) & mask()) << shift);
+}
+
+void ChannelArray::clear() {
+	if (words_.capacity() != 0) storagePool().release(std::move(words_));
+	words_ = {};
+}
+
+} // namespace voxel
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace voxel {
+
+// Extra per-voxel data kept beside the block types, one array per channel
+enum class VoxelChannel : std::uint8_t {
+	BlockLight = 0, // 4 bits, light from emitting blocks
+	SkyLight,       // 4 bits
+	State,          // 8 bits of block state (orientation, growth, ...)
+	Fluid,          // 4 bits, fluid level
+	Count
+};
+inline constexpr std::size_t kVoxelChannelCount = static_cast<std::size_t>(VoxelChannel::Count);
+
+inline constexpr int channelBits(VoxelChannel c) { return c == VoxelChannel::State ? 8 : 4; }
+
+// One optional channel: 4 or 8 bits per voxel, packed in linear
+// (y * sizeZ + z) * sizeX + x order like OccupancyMask. Every voxel reads 0
+// until one is written non-zero; only then are words taken from
+// storagePool(), so chunks that never use a channel pay nothing for it
+// and passes over block types never touch channel memory.
+class ChannelArray {
+public:
+	explicit ChannelArray(std::size_t count = 0, int bits = 4);
+	~ChannelArray();
+	ChannelArray(const ChannelArray& other);
+	ChannelArray(ChannelArray&& other) noexcept;
+	ChannelArray& operator=(const ChannelArray& other);
+	ChannelArray& operator=(ChannelArray&& other) noexcept;
+
+	std::size_t size() const { return count_; }
+	int bits() const { return bits_; }
+	bool allocated() const { return !words_.empty(); }
+
+	std::uint8_t get(std::size_t i) const {
+		if (words_.empty()) return 0;
+		const std::size_t bit = i * static_cast<std::size_t>(bits_);
+		return static_cast<std::uint8_t>((words_[bit >> 6] >> (bit & 63)) & mask());
+	}
+	void set(std::size_t i, std::uint8_t v);
+	// Zero every voxel and give the words back
+	void clear();
+
+	std::size_t memoryUsage() const { return words_.capacity() * sizeof(std::uint64_t); }
+
+private:
+	std::size_t count_ {0};
+	int bits_ {4};
+	std::vector<std::uint64_t> words_;
+
+	std::uint64_t mask() const { return (1ull << bits_) - 1ull; }
+};
+
+} // namespace voxel
@@ -1,56 +1,552 @@
 #include "chunk.hpp"
+#include "../core/crc32c.hpp"
+#include "../core/debug_counters.hpp"
+#include "byte_io.hpp"
+#include <algorithm>
+#include <bit>
 #include <fstream>
 #include <cstring>
+#include <utility>
+#include <vector>
 
 namespace voxel {
 
-Chunk::Chunk(int sizeX, int sizeY, int sizeZ)
-	: sizeX_(sizeX), sizeY_(sizeY), sizeZ_(sizeZ), voxels_(static_cast<size_t>(sizeX) * sizeY * sizeZ) {}
+// Bodies, control block included, come from the storage pool, so the
+// clone a write makes while a snapshot holds the body stays off the heap
+template<class... Args>
+static std::shared_ptr<ChunkBody> makeBody(Args&&... args) {
+	return std::allocate_shared<ChunkBody>(PoolAllocator<ChunkBody>(), std::forward<Args>(args)...);
+}
+
+Chunk::Chunk(int sizeX, int sizeY, int sizeZ, BlockType fill, ChunkLayout layout)
+	: body_(makeBody(static_cast<size_t>(sizeX) * sizeY * sizeZ, fill)) {
+	setShape(sizeX, sizeY, sizeZ, layout);
+}
+
+void Chunk::detach() {
+	body_ = makeBody(*body_);
+	++core::debugCounters().snapshotClones;
+}
+
+void Chunk::fill(BlockType t) {
+	if (body_.use_count() > 1) {
+		// Only the channels survive a fill; start a fresh body for the rest
+		auto fresh = makeBody(body_->storage.size(), t);
+		for (std::size_t c = 0; c < kVoxelChannelCount; ++c) fresh->channels[c] = body_->channels[c];
+		body_ = std::move(fresh);
+	} else {
+		body_->storage.fill(t);
+		body_->occupancy.fill(t != BlockType::Air);
+		dropSummary();
+	}
+	dirty_ = true;
+	editMask_ = kEditVoxels | kEditFaces;
+	++version_;
+}
+
+void Chunk::setShape(int sizeX, int sizeY, int sizeZ, ChunkLayout layout) {
+	sizeX_ = sizeX; sizeY_ = sizeY; sizeZ_ = sizeZ;
+	pow2_ = std::has_single_bit(static_cast<unsigned>(sizeX)) && std::has_single_bit(static_cast<unsigned>(sizeZ));
+	shiftX_ = std::countr_zero(static_cast<unsigned>(sizeX));
+	shiftXZ_ = shiftX_ + std::countr_zero(static_cast<unsigned>(sizeZ));
+	table_ = layoutTable(layout, sizeX, sizeY, sizeZ);
+	layout_ = table_ ? layout : ChunkLayout::Linear;
+}
+
+void Chunk::clearChannel(VoxelChannel c) {
+	if (!hasChannel(c)) return;
+	writable(0, 0, 0, sizeX_, sizeY_, sizeZ_).channels[static_cast<std::size_t>(c)].clear();
+}
+
+std::size_t Chunk::memoryUsage() const {
+	std::size_t bytes = body_->storage.memoryUsage() + body_->occupancy.memoryUsage();
+	for (const ChannelArray& ch : body_->channels) bytes += ch.memoryUsage();
+	return bytes;
+}
+
+void Chunk::copyTypes(BlockType* out) const {
+	const PaletteStorage& storage = body_->storage;
+	if (!table_) {
+		storage.decode(out);
+		return;
+	}
+	// Unpack in storage order, then scatter to linear positions
+	thread_local std::vector<BlockType> scratch;
+	scratch.resize(storage.size());
+	storage.decode(scratch.data());
+	for (size_t i = 0; i < scratch.size(); ++i) {
+		const std::uint32_t c = table_->coords[i];
+		out[(static_cast<size_t>(LayoutTable::coordY(c)) * sizeZ_ + LayoutTable::coordZ(c)) * sizeX_ + LayoutTable::coordX(c)] = scratch[i];
+	}
+}
+
+void Chunk::assignTypes(const BlockType* types) {
+	const std::size_t n = body_->storage.size();
+	auto fresh = makeBody(n, types[0]);
+	for (std::size_t c = 0; c < kVoxelChannelCount; ++c) fresh->channels[c] = body_->channels[c];
+	ChunkBody& b = *fresh;
+	for (std::size_t i = 0; i < n;) {
+		const BlockType t = types[i];
+		std::size_t e = i + 1;
+		while (e < n && types[e] == t) ++e;
+		b.occupancy.setRange(i, e, t != BlockType::Air);
+		if (!table_) b.storage.fillRange(i, e, t);
+		i = e;
+	}
+	if (table_) {
+		for (std::size_t i = 0; i < n; ++i) {
+			const std::uint32_t c = table_->coords[i];
+			b.storage.set(i, types[linearIndex(LayoutTable::coordX(c), LayoutTable::coordY(c), LayoutTable::coordZ(c))]);
+		}
+	}
+	body_ = std::move(fresh);
+	if (b.occupancy.isUniform()) dropSummary();
+	else rebuildSummary();
+	dirty_ = true;
+	editMask_ = kEditVoxels | kEditFaces;
+	++version_;
+}
+
+void Chunk::fillBox(int x0, int y0, int z0, int x1, int y1, int z1, BlockType t) {
+	if (x0 >= x1 || y0 >= y1 || z0 >= z1) return;
+	ChunkBody& b = writable(x0, y0, z0, x1, y1, z1);
+	const bool solid = t != BlockType::Air;
+	// Linear-order spans covering the box: whole XZ layers when rows and
+	// columns span the chunk, whole Z runs of rows when rows do, else rows
+	auto forEachSpan = [&](auto&& f) {
+		const std::size_t rowLen = static_cast<std::size_t>(x1 - x0);
+		const bool fullRows = x0 == 0 && x1 == sizeX_;
+		if (fullRows && z0 == 0 && z1 == sizeZ_) {
+			f(linearIndex(0, y0, 0), linearIndex(0, y1 - 1, 0) + static_cast<std::size_t>(sizeX_) * sizeZ_);
+			return;
+		}
+		for (int y = y0; y < y1; ++y) {
+			if (fullRows) {
+				f(linearIndex(0, y, z0), linearIndex(0, y, z1 - 1) + rowLen);
+				continue;
+			}
+			for (int z = z0; z < z1; ++z) {
+				const std::size_t start = linearIndex(x0, y, z);
+				f(start, start + rowLen);
+			}
+		}
+	};
+	forEachSpan([&](std::size_t s, std::size_t e) { b.occupancy.setRange(s, e, solid); });
+	refreshSummary(x0, y0, z0, x1, y1, z1);
+	if (table_) {
+		for (int y = y0; y < y1; ++y)
+			for (int z = z0; z < z1; ++z)
+				for (int x = x0; x < x1; ++x) b.storage.set(index(x, y, z), t);
+		return;
+	}
+	forEachSpan([&](std::size_t s, std::size_t e) { b.storage.fillRange(s, e, t); });
+}
+
+void Chunk::fillRows(const RowSpan* spans, std::size_t count) {
+	int x0 = sizeX_, y0 = sizeY_, z0 = sizeZ_, x1 = 0, y1 = 0, z1 = 0;
+	for (std::size_t i = 0; i < count; ++i) {
+		const RowSpan& s = spans[i];
+		if (s.x0 >= s.x1) continue;
+		x0 = std::min(x0, s.x0); x1 = std::max(x1, s.x1);
+		y0 = std::min(y0, s.y); y1 = std::max(y1, s.y + 1);
+		z0 = std::min(z0, s.z); z1 = std::max(z1, s.z + 1);
+	}
+	if (x0 >= x1) return;
+	ChunkBody& b = writable(x0, y0, z0, x1, y1, z1);
+	for (std::size_t i = 0; i < count; ++i) {
+		const RowSpan& s = spans[i];
+		if (s.x0 >= s.x1) continue;
+		const std::size_t start = linearIndex(s.x0, s.y, s.z);
+		const std::size_t end = start + static_cast<std::size_t>(s.x1 - s.x0);
+		b.occupancy.setRange(start, end, s.t != BlockType::Air);
+		if (!table_) {
+			b.storage.fillRange(start, end, s.t);
+			continue;
+		}
+		for (int x = s.x0; x < s.x1; ++x) b.storage.set(index(x, s.y, s.z), s.t);
+	}
+	refreshSummary(x0, y0, z0, x1, y1, z1);
+}
+
+bool Chunk::replaceInBox(int x0, int y0, int z0, int x1, int y1, int z1, BlockType from, BlockType to) {
+	if (from == to || x0 >= x1 || y0 >= y1 || z0 >= z1 || !body_->storage.mayContain(from)) return false;
+	if (body_->storage.isUniform()) {
+		// Every voxel is `from`; this is a plain fill
+		fillBox(x0, y0, z0, x1, y1, z1, to);
+		return true;
+	}
+	// The body is only made writable once a voxel matches, so a section
+	// holding `from` elsewhere keeps sharing its snapshot and stays clean
+	ChunkBody* b = nullptr;
+	for (int y = y0; y < y1; ++y)
+		for (int z = z0; z < z1; ++z)
+			for (int x = x0; x < x1; ++x) {
+				if (body_->storage.get(index(x, y, z)) != from) continue;
+				if (!b) b = &writable(x0, y0, z0, x1, y1, z1);
+				b->storage.set(index(x, y, z), to);
+				b->occupancy.set(linearIndex(x, y, z), to != BlockType::Air);
+			}
+	if (!b) return false;
+	refreshSummary(x0, y0, z0, x1, y1, z1);
+	return true;
+}
+
+bool Chunk::boxHolds(int x0, int y0, int z0, int x1, int y1, int z1, BlockType t) const {
+	const PaletteStorage& storage = body_->storage;
+	if (storage.isUniform()) return storage.uniformValue() == t;
+	if (!storage.mayContain(t)) return false;
+	for (int y = y0; y < y1; ++y)
+		for (int z = z0; z < z1; ++z)
+			for (int x = x0; x < x1; ++x) {
+				if (storage.get(index(x, y, z)) != t) return false;
+			}
+	return true;
+}
+
+int Chunk::minSolidY() const {
+	const ChunkBody& b = *body_;
+	if (b.occupancy.isUniform()) return b.occupancy.allAir() ? -1 : 0;
+	return b.minY;
+}
+
+int Chunk::maxSolidY() const {
+	const ChunkBody& b = *body_;
+	if (b.occupancy.isUniform()) return b.occupancy.allAir() ? -1 : sizeY_ - 1;
+	return b.maxY;
+}
+
+int Chunk::columnHeight(int x, int z) const {
+	const ChunkBody& b = *body_;
+	if (b.occupancy.isUniform()) return b.occupancy.allAir() ? 0 : sizeY_;
+	return b.heights[static_cast<std::size_t>(z) * sizeX_ + x];
+}
+
+void Chunk::noteSolidChange(int x, int y, int z, bool solid) {
+	ChunkBody& b = *body_;
+	if (b.occupancy.isUniform()) {
+		dropSummary();
+		return;
+	}
+	if (b.heights.empty()) {
+		rebuildSummary();
+		return;
+	}
+	std::uint16_t& h = b.heights[static_cast<std::size_t>(z) * sizeX_ + x];
+	if (solid) {
+		++b.layerSolid[y];
+		if (y + 1 > h) h = static_cast<std::uint16_t>(y + 1);
+		if (b.minY < 0 || y < b.minY) b.minY = y;
+		if (y > b.maxY) b.maxY = y;
+		return;
+	}
+	--b.layerSolid[y];
+	if (y + 1 == h) h = static_cast<std::uint16_t>(scanColumn(x, z, y));
+	if (b.layerSolid[y] == 0 && (y == b.minY || y == b.maxY)) updateYBounds();
+}
+
+int Chunk::scanColumn(int x, int z, int fromY) const {
+	for (int y = fromY - 1; y >= 0; --y) {
+		if (body_->occupancy.test(linearIndex(x, y, z))) return y + 1;
+	}
+	return 0;
+}
+
+// Solid voxels in layer y; layers are contiguous in linear order
+static std::uint32_t countLayer(const OccupancyMask& occ, std::size_t start, std::size_t len) {
+	std::uint32_t n = 0;
+	for (std::size_t i = 0; i < len; i += 64) {
+		n += static_cast<std::uint32_t>(std::popcount(occ.bits(start + i, static_cast<int>(std::min<std::size_t>(64, len - i)))));
+	}
+	return n;
+}
 
-Voxel& Chunk::at(int x, int y, int z) {
-	return voxels_[index(x, y, z)];
+void Chunk::rebuildSummary() {
+	ChunkBody& b = *body_;
+	const std::size_t layer = static_cast<std::size_t>(sizeX_) * sizeZ_;
+	b.layerSolid.assign(static_cast<std::size_t>(sizeY_), 0);
+	b.heights.assign(layer, 0);
+	for (int y = 0; y < sizeY_; ++y) {
+		b.layerSolid[y] = countLayer(b.occupancy, linearIndex(0, y, 0), layer);
+		if (b.layerSolid[y] == 0) continue;
+		// Walking up, the last solid layer seen in a column is its top
+		for (int z = 0; z < sizeZ_; ++z) {
+			for (int x0 = 0; x0 < sizeX_; x0 += 64) {
+				std::uint64_t row = b.occupancy.bits(linearIndex(x0, y, z), std::min(64, sizeX_ - x0));
+				while (row) {
+					const int x = x0 + std::countr_zero(row);
+					row &= row - 1;
+					b.heights[static_cast<std::size_t>(z) * sizeX_ + x] = static_cast<std::uint16_t>(y + 1);
+				}
+			}
+		}
+	}
+	updateYBounds();
 }
 
-const Voxel& Chunk::at(int x, int y, int z) const {
-	return voxels_[index(x, y, z)];
+void Chunk::refreshSummary(int x0, int y0, int z0, int x1, int y1, int z1) {
+	ChunkBody& b = *body_;
+	if (b.occupancy.isUniform()) {
+		dropSummary();
+		return;
+	}
+	if (b.heights.empty()) {
+		rebuildSummary();
+		return;
+	}
+	const std::size_t layer = static_cast<std::size_t>(sizeX_) * sizeZ_;
+	for (int y = y0; y < y1; ++y) b.layerSolid[y] = countLayer(b.occupancy, linearIndex(0, y, 0), layer);
+	for (int z = z0; z < z1; ++z) {
+		for (int x = x0; x < x1; ++x) {
+			std::uint16_t& h = b.heights[static_cast<std::size_t>(z) * sizeX_ + x];
+			// Tops above the box are untouched by it
+			if (h <= y1) h = static_cast<std::uint16_t>(scanColumn(x, z, y1));
+		}
+	}
+	updateYBounds();
 }
 
+void Chunk::updateYBounds() {
+	ChunkBody& b = *body_;
+	b.minY = b.maxY = -1;
+	for (int y = 0; y < sizeY_; ++y) {
+		if (b.layerSolid[y] == 0) continue;
+		if (b.minY < 0) b.minY = y;
+		b.maxY = y;
+	}
+}
+
+void Chunk::dropSummary() {
+	ChunkBody& b = *body_;
+	decltype(b.layerSolid)().swap(b.layerSolid);
+	decltype(b.heights)().swap(b.heights);
+	b.minY = b.maxY = -1;
+}
+
+// Version 1, 'VCXL': magic, three native ints, then one raw byte per
+// voxel. Still read; no longer written.
 static constexpr std::uint32_t kChunkMagic = 0x5643584C; // 'VCXL'
+// Version 2, 'VCX2', little-endian: magic, u16 sizes, u8 encoding, u8
+// channel bits, u32 payload bytes, u32 CRC-32C of the payload, then the
+// payload. Encoding 0 is raw bytes in linear order. Encoding 1 is a varint
+// palette count and the palette, then runs in linear order, each one
+// varint token (length << paletteBits | palette index). The block types
+// are followed by each channel whose bit (1 << VoxelChannel) is set, in
+// channel order, as runs in linear order: varint length, value byte.
+static constexpr std::uint32_t kChunkMagicV2 = 0x56435832; // 'VCX2'
+static constexpr std::uint8_t kEncodingRaw = 0;
+static constexpr std::uint8_t kEncodingRuns = 1;
+static constexpr std::size_t kHeaderV2 = 20;
+
+static int paletteBits(std::size_t paletteSize) {
+	return paletteSize <= 1 ? 0 : std::bit_width(paletteSize - 1);
+}
+
+void Chunk::saveToBuffer(std::vector<std::uint8_t>& out) const {
+	const std::size_t count = static_cast<std::size_t>(sizeX_) * sizeY_ * sizeZ_;
+	out.clear();
+	putU32(out, kChunkMagicV2);
+	putU16(out, sizeX_);
+	putU16(out, sizeY_);
+	putU16(out, sizeZ_);
+	out.push_back(kEncodingRuns);
+	out.push_back(0);
+	putU32(out, 0); // payload bytes and checksum, patched below
+	putU32(out, 0);
+
+	// Palette-indexed runs, unless they come out larger than the raw bytes
+	thread_local std::vector<BlockType> types;
+	thread_local std::vector<std::uint8_t> runs;
+	types.resize(count);
+	copyTypes(types.data());
+	std::int16_t slot[256];
+	std::fill(std::begin(slot), std::end(slot), std::int16_t{-1});
+	std::uint8_t palette[256];
+	std::size_t paletteSize = 0;
+	for (std::size_t i = 0; i < count; ++i) {
+		const std::uint8_t t = static_cast<std::uint8_t>(types[i]);
+		if (slot[t] < 0) {
+			slot[t] = static_cast<std::int16_t>(paletteSize);
+			palette[paletteSize++] = t;
+		}
+	}
+	const int bits = paletteBits(paletteSize);
+	runs.clear();
+	for (std::size_t i = 0; i < count && runs.size() < count;) {
+		const BlockType t = types[i];
+		std::size_t e = i + 1;
+		while (e < count && types[e] == t) ++e;
+		putVarint(runs, ((e - i) << bits) | static_cast<std::size_t>(slot[static_cast<std::uint8_t>(t)]));
+		i = e;
+	}
+	if (runs.size() + paletteSize + 2 < count) {
+		putVarint(out, paletteSize);
+		out.insert(out.end(), palette, palette + paletteSize);
+		out.insert(out.end(), runs.begin(), runs.end());
+	} else {
+		out[10] = kEncodingRaw;
+		out.insert(out.end(), reinterpret_cast<const std::uint8_t*>(types.data()), reinterpret_cast<const std::uint8_t*>(types.data()) + count);
+	}
+	// Only channels that were ever written are stored
+	std::uint8_t channels = 0;
+	for (std::size_t c = 0; c < kVoxelChannelCount; ++c) {
+		const ChannelArray& a = body_->channels[c];
+		if (!a.allocated()) continue;
+		channels |= static_cast<std::uint8_t>(1u << c);
+		for (std::size_t i = 0; i < count;) {
+			const std::uint8_t v = a.get(i);
+			std::size_t e = i + 1;
+			while (e < count && a.get(e) == v) ++e;
+			putVarint(out, e - i);
+			out.push_back(v);
+			i = e;
+		}
+	}
+	out[11] = channels;
+	const std::uint32_t bytes = static_cast<std::uint32_t>(out.size() - kHeaderV2);
+	storeU32(out.data() + 12, bytes);
+	storeU32(out.data() + 16, core::crc32c(out.data() + kHeaderV2, bytes));
+}
+
+void Chunk::writeRun(ChunkBody& b, std::size_t begin, std::size_t end, BlockType t) const {
+	b.occupancy.setRange(begin, end, t != BlockType::Air);
+	if (!table_) {
+		b.storage.fillRange(begin, end, t);
+		return;
+	}
+	for (std::size_t i = begin; i < end; ++i) {
+		const int x = static_cast<int>(i % sizeX_);
+		const int z = static_cast<int>((i / sizeX_) % sizeZ_);
+		const int y = static_cast<int>(i / (static_cast<std::size_t>(sizeX_) * sizeZ_));
+		b.storage.set(table_->index(x, y, z), t);
+	}
+}
+
+bool Chunk::loadFromBuffer(const std::uint8_t* data, std::size_t size) {
+	std::uint32_t magic = 0;
+	if (size < sizeof(magic)) return false;
+	std::memcpy(&magic, data, sizeof(magic));
+	if (magic == kChunkMagic) return loadVersion1(data, size);
+
+	ByteReader in{ data, data + size };
+	int x = 0, y = 0, z = 0;
+	std::uint8_t encoding = 0, channels = 0;
+	std::uint32_t bytes = 0, crc = 0;
+	if (!in.u32(magic) || magic != kChunkMagicV2) return false;
+	if (!in.u16(x) || !in.u16(y) || !in.u16(z) || !in.byte(encoding) || !in.byte(channels)) return false;
+	if ((channels >> kVoxelChannelCount) != 0) return false;
+	if (!in.u32(bytes) || !in.u32(crc) || in.remaining() < bytes) return false;
+	if (x <= 0 || y <= 0 || z <= 0 || core::crc32c(in.p, bytes) != crc) return false;
+	const std::size_t count = static_cast<std::size_t>(x) * y * z;
+	ByteReader payload{ in.p, in.p + bytes };
+
+	// Runs are written straight into a fresh body, which replaces the
+	// current one only once the whole payload decoded. The body starts out
+	// uniform in the first run's type, so that run costs nothing.
+	// setShape may fall back to Linear for this shape, so the failure path
+	// restores the layout along with the size.
+	const int oldX = sizeX_, oldY = sizeY_, oldZ = sizeZ_;
+	const ChunkLayout oldLayout = layout_;
+	setShape(x, y, z, layout_);
+	std::shared_ptr<ChunkBody> body;
+	auto put = [&](std::size_t begin, std::size_t end, BlockType t) {
+		if (!body) body = makeBody(count, t);
+		else writeRun(*body, begin, end, t);
+	};
+	bool ok = false;
+	if (encoding == kEncodingRaw && payload.remaining() >= count) {
+		const BlockType* types = reinterpret_cast<const BlockType*>(payload.p);
+		for (std::size_t i = 0; i < count;) {
+			std::size_t e = i + 1;
+			while (e < count && types[e] == types[i]) ++e;
+			put(i, e, types[i]);
+			i = e;
+		}
+		payload.p += count;
+		ok = true;
+	} else if (encoding == kEncodingRuns) {
+		std::size_t paletteSize = 0;
+		ok = payload.varint(paletteSize) && paletteSize >= 1 && paletteSize <= 256 && payload.remaining() >= paletteSize;
+		if (ok) {
+			const std::uint8_t* palette = payload.p;
+			payload.p += paletteSize;
+			const int bits = paletteBits(paletteSize);
+			const std::size_t mask = (std::size_t{1} << bits) - 1;
+			for (std::size_t i = 0; ok && i < count;) {
+				std::size_t token = 0;
+				ok = payload.varint(token);
+				const std::size_t len = token >> bits;
+				const std::size_t index = token & mask;
+				ok = ok && len != 0 && len <= count - i && index < paletteSize;
+				if (!ok) break;
+				put(i, i + len, static_cast<BlockType>(palette[index]));
+				i += len;
+			}
+		}
+	}
+	for (std::size_t c = 0; ok && c < kVoxelChannelCount; ++c) {
+		if (!(channels & (1u << c))) continue;
+		ChannelArray& a = body->channels[c];
+		const std::size_t limit = (std::size_t{1} << a.bits()) - 1;
+		for (std::size_t i = 0; ok && i < count;) {
+			std::size_t len = 0;
+			std::uint8_t v = 0;
+			ok = payload.varint(len) && payload.byte(v) && len != 0 && len <= count - i && v <= limit;
+			if (!ok) break;
+			if (v != 0) {
+				for (std::size_t k = i; k < i + len; ++k) a.set(k, v);
+			}
+			i += len;
+		}
+	}
+	if (!ok) {
+		setShape(oldX, oldY, oldZ, oldLayout);
+		return false;
+	}
+	body_ = std::move(body);
+	if (body_->occupancy.isUniform()) dropSummary();
+	else rebuildSummary();
+	++version_;
+	dirty_ = false;
+	editMask_ = 0;
+	return true;
+}
+
+bool Chunk::loadVersion1(const std::uint8_t* data, std::size_t size) {
+	const std::size_t header = sizeof(std::uint32_t) + 3 * sizeof(int);
+	if (size < header) return false;
+	int x = 0, y = 0, z = 0;
+	std::memcpy(&x, data + 4, sizeof(x));
+	std::memcpy(&y, data + 8, sizeof(y));
+	std::memcpy(&z, data + 12, sizeof(z));
+	if (x <= 0 || y <= 0 || z <= 0 || x > 65535 || y > 65535 || z > 65535) return false;
+	if (size - header < static_cast<std::size_t>(x) * y * z) return false;
+	setShape(x, y, z, layout_);
+	// Snapshots keep the previous contents; the load fills a fresh body
+	body_ = makeBody(static_cast<size_t>(sizeX_) * sizeY_ * sizeZ_, BlockType::Air);
+	assignTypes(reinterpret_cast<const BlockType*>(data + header));
+	dirty_ = false;
+	editMask_ = 0;
+	return true;
+}
 
 bool Chunk::saveToFile(const char* path) const {
+	std::vector<std::uint8_t> bytes;
+	saveToBuffer(bytes);
 	std::ofstream out(path, std::ios::binary);
 	if (!out) return false;
-	std::uint32_t magic = kChunkMagic;
-	out.write(reinterpret_cast<const char*>(&magic), sizeof(magic));
-	out.write(reinterpret_cast<const char*>(&sizeX_), sizeof(sizeX_));
-	out.write(reinterpret_cast<const char*>(&sizeY_), sizeof(sizeY_));
-	out.write(reinterpret_cast<const char*>(&sizeZ_), sizeof(sizeZ_));
-	for (const Voxel& v : voxels_) {
-		std::uint8_t type = static_cast<std::uint8_t>(v.type);
-		out.write(reinterpret_cast<const char*>(&type), sizeof(type));
-	}
-	return true;
+	out.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+	return static_cast<bool>(out);
 }
 
 bool Chunk::loadFromFile(const char* path) {
-	std::ifstream in(path, std::ios::binary);
+	std::ifstream in(path, std::ios::binary | std::ios::ate);
 	if (!in) return false;
-	std::uint32_t magic = 0;
-	in.read(reinterpret_cast<char*>(&magic), sizeof(magic));
-	if (magic != kChunkMagic) return false;
-	int x=0,y=0,z=0;
-	in.read(reinterpret_cast<char*>(&x), sizeof(x));
-	in.read(reinterpret_cast<char*>(&y), sizeof(y));
-	in.read(reinterpret_cast<char*>(&z), sizeof(z));
-	if (x<=0||y<=0||z<=0) return false;
-	sizeX_ = x; sizeY_ = y; sizeZ_ = z;
-	voxels_.assign(static_cast<size_t>(sizeX_) * sizeY_ * sizeZ_, Voxel{});
-	for (Voxel& v : voxels_) {
-		std::uint8_t type = 0;
-		in.read(reinterpret_cast<char*>(&type), sizeof(type));
-		v.type = static_cast<BlockType>(type);
-	}
-	return true;
+	const std::streamoff size = in.tellg();
+	if (size <= 0) return false;
+	std::vector<std::uint8_t> bytes(static_cast<std::size_t>(size));
+	in.seekg(0);
+	if (!in.read(reinterpret_cast<char*>(bytes.data()), size)) return false;
+	return loadFromBuffer(bytes.data(), bytes.size());
 }
 
 } // namespace voxel
@@ -1,35 +1,271 @@
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
+#include <memory>
 #include <vector>
 #include "voxel.hpp"
+#include "palette_storage.hpp"
+#include "chunk_layout.hpp"
+#include "occupancy_mask.hpp"
+#include "channel_array.hpp"
+#include "storage_pool.hpp"
 
 namespace voxel {
 
+class Chunk;
+
+// Bits of Chunk::editMask(). kEditVoxels is set by any edit; the face bits
+// say which border layers were touched, so neighbours sharing that face
+// need remeshing too. Faces are numbered axis * 2 + (dir > 0), as in
+// VoxelCursor.
+inline constexpr std::uint8_t kEditVoxels = 1u << 6;
+inline constexpr std::uint8_t kEditFaces = 0x3F;
+inline constexpr std::uint8_t editFaceBit(int axis, int dir) {
+	return static_cast<std::uint8_t>(1u << (axis * 2 + (dir > 0 ? 1 : 0)));
+}
+
+// Writable handle returned by Chunk::at. Voxels are bit-packed, so there is
+// no Voxel object to reference; reads and assignments go through the chunk.
+class VoxelRef {
+public:
+	VoxelRef(Chunk& chunk, int x, int y, int z) : chunk_(chunk), x_(x), y_(y), z_(z) {}
+
+	operator Voxel() const;
+	VoxelRef& operator=(const Voxel& v);
+	VoxelRef& operator=(const VoxelRef& other) { return *this = static_cast<Voxel>(other); }
+	BlockType type() const { return static_cast<Voxel>(*this).type; }
+
+private:
+	Chunk& chunk_;
+	int x_, y_, z_;
+};
+
+// Local run [x0,x1) of row (y, z) set to t; see Chunk::fillRows
+struct RowSpan {
+	int x0, x1, y, z;
+	BlockType t;
+};
+
+// Voxel payload of a chunk: block types, solid bits and the summaries
+// derived from them. Shared by a chunk and its snapshots until the chunk
+// is next written; see Chunk::snapshot.
+struct ChunkBody {
+	ChunkBody(std::size_t count, BlockType fill)
+		: storage(count, fill), occupancy(count, fill != BlockType::Air) {
+		for (std::size_t c = 0; c < kVoxelChannelCount; ++c) {
+			channels[c] = ChannelArray(count, channelBits(static_cast<VoxelChannel>(c)));
+		}
+	}
+
+	PaletteStorage storage;
+	OccupancyMask occupancy;
+	// Optional light/state/fluid data, each allocated on first use
+	ChannelArray channels[kVoxelChannelCount];
+	// Per-layer solid counts and per-column heights. Empty while the
+	// occupancy is uniform (all air or all solid), where both follow from it.
+	std::vector<std::uint32_t, PoolAllocator<std::uint32_t>> layerSolid;
+	std::vector<std::uint16_t, PoolAllocator<std::uint16_t>> heights;
+	int minY {-1};
+	int maxY {-1};
+};
+
 class Chunk {
 public:
-    Chunk(int sizeX, int sizeY, int sizeZ);
+	// Layouts the shape does not support (see layoutSupports) fall back to Linear
+	Chunk(int sizeX, int sizeY, int sizeZ, BlockType fill = BlockType::Air, ChunkLayout layout = ChunkLayout::Linear);
 
-    int sizeX() const { return sizeX_; }
-    int sizeY() const { return sizeY_; }
-    int sizeZ() const { return sizeZ_; }
+	int sizeX() const { return sizeX_; }
+	int sizeY() const { return sizeY_; }
+	int sizeZ() const { return sizeZ_; }
+	ChunkLayout layout() const { return layout_; }
 
-    Voxel& at(int x, int y, int z);
-    const Voxel& at(int x, int y, int z) const;
+	BlockType get(int x, int y, int z) const { return body_->storage.get(index(x, y, z)); }
+	void set(int x, int y, int z, BlockType t) {
+		// Rewriting the same type is not an edit: no version bump, no clone
+		if (get(x, y, z) == t) return;
+		ChunkBody& b = writable(x, y, z, x + 1, y + 1, z + 1);
+		const std::size_t li = linearIndex(x, y, z);
+		const bool solid = t != BlockType::Air;
+		const bool was = b.occupancy.test(li);
+		b.storage.set(index(x, y, z), t);
+		b.occupancy.set(li, solid);
+		if (was != solid) noteSolidChange(x, y, z, solid);
+	}
 
-    bool saveToFile(const char* path) const;
-    bool loadFromFile(const char* path);
+	// Solid/air bits kept in step with every write; see OccupancyMask
+	bool isSolid(int x, int y, int z) const { return body_->occupancy.test(linearIndex(x, y, z)); }
+	std::size_t solidCount() const { return body_->occupancy.solidCount(); }
+	const OccupancyMask& occupancy() const { return body_->occupancy; }
+
+	// Extra channels (see VoxelChannel). A channel costs no memory until a
+	// voxel in it is set non-zero; meshing and raycasts never read them.
+	std::uint8_t channel(VoxelChannel c, int x, int y, int z) const {
+		return body_->channels[static_cast<std::size_t>(c)].get(linearIndex(x, y, z));
+	}
+	void setChannel(VoxelChannel c, int x, int y, int z, std::uint8_t v) {
+		if (channel(c, x, y, z) == v) return;
+		writable(x, y, z, x + 1, y + 1, z + 1).channels[static_cast<std::size_t>(c)].set(linearIndex(x, y, z), v);
+	}
+	bool hasChannel(VoxelChannel c) const { return body_->channels[static_cast<std::size_t>(c)].allocated(); }
+	const ChannelArray& channelData(VoxelChannel c) const { return body_->channels[static_cast<std::size_t>(c)]; }
+	// Drop a channel back to all zero and release its memory
+	void clearChannel(VoxelChannel c);
+
+	// Summaries kept up to date on write. Y bounds are -1 for an empty
+	// chunk; column heights are the top solid y + 1, or 0 for an empty column.
+	int minSolidY() const;
+	int maxSolidY() const;
+	int columnHeight(int x, int z) const;
+
+	// Set the local box [x0,x1) x [y0,y1) x [z0,z1) to t. Linear chunks write
+	// whole rows (or slabs, when rows span the chunk) as one range.
+	void fillBox(int x0, int y0, int z0, int x1, int y1, int z1, BlockType t);
+	// Write a batch of row runs as one edit: one version bump and one
+	// summary refresh over the runs' bounds
+	void fillRows(const RowSpan* spans, std::size_t count);
+	// Within the local box, change every `from` voxel to `to`. Returns
+	// whether any voxel matched; the chunk is only marked edited if one did.
+	bool replaceInBox(int x0, int y0, int z0, int x1, int y1, int z1, BlockType from, BlockType to);
+	// Whether every voxel in the local box is t
+	bool boxHolds(int x0, int y0, int z0, int x1, int y1, int z1, BlockType t) const;
+
+	// Copy all block types into out, indexed (y * sizeZ + z) * sizeX + x
+	// regardless of the storage layout
+	void copyTypes(BlockType* out) const;
+	// The reverse: replace every block type from a linear array, writing
+	// runs of equal types as spans. Channels are kept.
+	void assignTypes(const BlockType* types);
+
+	// Visit every voxel as f(x, y, z, type) in storage order, which is the
+	// cache-friendly walk for whichever layout the chunk uses
+	template<class F>
+	void forEachVoxel(F&& f) const {
+		const PaletteStorage& storage = body_->storage;
+		if (table_) {
+			for (std::size_t i = 0; i < storage.size(); ++i) {
+				const std::uint32_t c = table_->coords[i];
+				f(LayoutTable::coordX(c), LayoutTable::coordY(c), LayoutTable::coordZ(c), storage.get(i));
+			}
+			return;
+		}
+		std::size_t i = 0;
+		for (int y = 0; y < sizeY_; ++y)
+			for (int z = 0; z < sizeZ_; ++z)
+				for (int x = 0; x < sizeX_; ++x) f(x, y, z, storage.get(i++));
+	}
+
+	VoxelRef at(int x, int y, int z) { return VoxelRef(*this, x, y, z); }
+	Voxel at(int x, int y, int z) const { return Voxel{ get(x, y, z) }; }
+
+	// Uniform chunks (all air, all one block) hold no voxel buffer at all
+	bool isUniform() const { return body_->storage.isUniform(); }
+	BlockType uniformType() const { return body_->storage.uniformValue(); }
+	void fill(BlockType t);
+
+	// Set by any edit since the chunk was created, loaded or last saved
+	bool isDirty() const { return dirty_; }
+	void clearDirty() { dirty_ = false; }
+	// Bumped by every write; a snapshot keeps the version it was taken at
+	std::uint64_t version() const { return version_; }
+	// Continue the version sequence from v after restoring a chunk's
+	// contents elsewhere (e.g. out of the cold tier), so versions seen
+	// before the round trip never repeat
+	void resumeVersion(std::uint64_t v) { if (v > version_) version_ = v; }
+	// Edits since the mask was last taken; see kEditVoxels and editFaceBit.
+	// Whoever remeshes takes it, independently of the save-side dirty flag.
+	std::uint8_t editMask() const { return editMask_; }
+	// Flag every face for remeshing without counting as an edit, e.g.
+	// after the contents were replaced by a load
+	void markRemesh() { editMask_ = kEditVoxels | kEditFaces; }
+	std::uint8_t takeEditMask() {
+		const std::uint8_t m = editMask_;
+		editMask_ = 0;
+		return m;
+	}
+
+	// Immutable copy of the chunk as of now, safe to read from any thread
+	// while this chunk keeps being edited. It shares the voxel body, so
+	// taking one costs no copy; the next write to this chunk clones the
+	// body first if a snapshot still holds it. Readers never lock.
+	std::shared_ptr<const Chunk> snapshot() const { return std::make_shared<const Chunk>(*this); }
+	// True while a snapshot (or chunk copy) still shares the voxel body
+	bool isShared() const { return body_.use_count() > 1; }
+
+	// Bytes of voxel data held by this chunk, occupancy bits and channels included
+	std::size_t memoryUsage() const;
+	const PaletteStorage& storage() const { return body_->storage; }
+
+	// Files hold block types and every channel in use; loading replaces
+	// both. Saves use the checksummed, run-length 'VCX2' format; loads also
+	// accept the old raw 'VCXL' files, which have no channels. The buffer forms carry the same bytes, for
+	// containers such as RegionFile; each file call is one bulk read or
+	// write of that buffer. A failed load leaves the chunk unchanged.
+	void saveToBuffer(std::vector<std::uint8_t>& out) const;
+	bool loadFromBuffer(const std::uint8_t* data, std::size_t size);
+	bool saveToFile(const char* path) const;
+	bool loadFromFile(const char* path);
 
 private:
-    int sizeX_;
-    int sizeY_;
-    int sizeZ_;
-    std::vector<Voxel> voxels_;
-    int index(int x, int y, int z) const {
-        return (y * sizeZ_ + z) * sizeX_ + x;
-    }
+	int sizeX_ {0};
+	int sizeY_ {0};
+	int sizeZ_ {0};
+	// Power-of-two shapes index with shifts; others fall back to multiplies
+	bool pow2_ {false};
+	int shiftX_ {0};
+	int shiftXZ_ {0};
+	ChunkLayout layout_ {ChunkLayout::Linear};
+	bool dirty_ {false};
+	std::uint8_t editMask_ {0};
+	std::uint64_t version_ {0};
+	// Shared addressing tables; null for Linear
+	const LayoutTable* table_ {nullptr};
+	std::shared_ptr<ChunkBody> body_;
+	// Every write to the local box [x0,x1) x [y0,y1) x [z0,z1) goes through
+	// here: marks the chunk edited, notes the border faces the box touches
+	// and gives the chunk a body of its own if a snapshot still reads it
+	ChunkBody& writable(int x0, int y0, int z0, int x1, int y1, int z1) {
+		if (body_.use_count() > 1) detach();
+		dirty_ = true;
+		++version_;
+		std::uint8_t m = kEditVoxels;
+		if (x0 == 0) m |= editFaceBit(0, -1);
+		if (x1 == sizeX_) m |= editFaceBit(0, 1);
+		if (y0 == 0) m |= editFaceBit(1, -1);
+		if (y1 == sizeY_) m |= editFaceBit(1, 1);
+		if (z0 == 0) m |= editFaceBit(2, -1);
+		if (z1 == sizeZ_) m |= editFaceBit(2, 1);
+		editMask_ |= m;
+		return *body_;
+	}
+	void detach();
+	// Set linear-order voxels [begin, end) of b to t, for loads
+	void writeRun(ChunkBody& b, std::size_t begin, std::size_t end, BlockType t) const;
+	bool loadVersion1(const std::uint8_t* data, std::size_t size);
+	void noteSolidChange(int x, int y, int z, bool solid);
+	void refreshSummary(int x0, int y0, int z0, int x1, int y1, int z1);
+	void rebuildSummary();
+	void dropSummary();
+	void updateYBounds();
+	int scanColumn(int x, int z, int fromY) const;
+	void setShape(int sizeX, int sizeY, int sizeZ, ChunkLayout layout);
+	std::size_t index(int x, int y, int z) const {
+		if (table_) return table_->index(x, y, z);
+		return linearIndex(x, y, z);
+	}
+	std::size_t linearIndex(int x, int y, int z) const {
+		if (pow2_) {
+			return (static_cast<std::size_t>(y) << shiftXZ_) | (static_cast<std::size_t>(z) << shiftX_) | static_cast<std::size_t>(x);
+		}
+		return static_cast<std::size_t>((y * sizeZ_ + z) * sizeX_ + x);
+	}
 };
 
-} // namespace voxel
+inline VoxelRef::operator Voxel() const { return Voxel{ chunk_.get(x_, y_, z_) }; }
 
+inline VoxelRef& VoxelRef::operator=(const Voxel& v) {
+	chunk_.set(x_, y_, z_, v.type);
+	return *this;
+}
 
+} // namespace voxel
@@ -0,0 +1,96 @@
+#include "chunk_codec.hpp"
+#include "byte_io.hpp"
+
+namespace voxel {
+
+template<class Get>
+static void putRuns(std::vector<std::uint8_t>& out, std::size_t count, Get get) {
+	for (std::size_t i = 0; i < count;) {
+		const std::uint8_t v = get(i);
+		std::size_t e = i + 1;
+		while (e < count && get(e) == v) ++e;
+		out.push_back(v);
+		putVarint(out, e - i);
+		i = e;
+	}
+}
+
+// Runs must cover exactly count values
+template<class Put>
+static bool readRuns(ByteReader& in, std::size_t count, Put put) {
+	for (std::size_t i = 0; i < count;) {
+		std::uint8_t v = 0;
+		std::size_t len = 0;
+		if (!in.byte(v) || !in.varint(len) || len == 0 || len > count - i) return false;
+		put(i, i + len, v);
+		i += len;
+	}
+	return true;
+}
+
+void encodeChunkRle(const Chunk& chunk, std::vector<std::uint8_t>& out) {
+	out.clear();
+	putU16(out, chunk.sizeX());
+	putU16(out, chunk.sizeY());
+	putU16(out, chunk.sizeZ());
+	out.push_back(static_cast<std::uint8_t>(chunk.layout()));
+	const std::size_t count = static_cast<std::size_t>(chunk.sizeX()) * chunk.sizeY() * chunk.sizeZ();
+	if (chunk.isUniform()) {
+		out.push_back(static_cast<std::uint8_t>(chunk.uniformType()));
+		putVarint(out, count);
+	} else {
+		thread_local std::vector<BlockType> types;
+		types.resize(count);
+		chunk.copyTypes(types.data());
+		putRuns(out, count, [&](std::size_t i) { return static_cast<std::uint8_t>(types[i]); });
+	}
+	std::uint8_t present = 0;
+	for (std::size_t c = 0; c < kVoxelChannelCount; ++c) {
+		if (chunk.hasChannel(static_cast<VoxelChannel>(c))) present |= static_cast<std::uint8_t>(1u << c);
+	}
+	out.push_back(present);
+	for (std::size_t c = 0; c < kVoxelChannelCount; ++c) {
+		if (!(present & (1u << c))) continue;
+		const ChannelArray& ch = chunk.channelData(static_cast<VoxelChannel>(c));
+		putRuns(out, count, [&](std::size_t i) { return ch.get(i); });
+	}
+}
+
+bool decodeChunkRle(const std::uint8_t* data, std::size_t size, Chunk& out) {
+	ByteReader in{ data, data + size };
+	int sx = 0, sy = 0, sz = 0;
+	std::uint8_t layout = 0;
+	if (!in.u16(sx) || !in.u16(sy) || !in.u16(sz) || !in.byte(layout)) return false;
+	if (sx <= 0 || sy <= 0 || sz <= 0 || layout > static_cast<std::uint8_t>(ChunkLayout::Bricked4)) return false;
+	const std::size_t count = static_cast<std::size_t>(sx) * sy * sz;
+
+	thread_local std::vector<BlockType> types;
+	types.resize(count);
+	const bool typesOk = readRuns(in, count, [&](std::size_t b, std::size_t e, std::uint8_t v) {
+		for (std::size_t i = b; i < e; ++i) types[i] = static_cast<BlockType>(v);
+	});
+	if (!typesOk) return false;
+	Chunk chunk(sx, sy, sz, types[0], static_cast<ChunkLayout>(layout));
+	chunk.assignTypes(types.data());
+
+	std::uint8_t present = 0;
+	if (!in.byte(present)) return false;
+	for (std::size_t c = 0; c < kVoxelChannelCount; ++c) {
+		if (!(present & (1u << c))) continue;
+		const VoxelChannel ch = static_cast<VoxelChannel>(c);
+		const bool ok = readRuns(in, count, [&](std::size_t b, std::size_t e, std::uint8_t v) {
+			if (v == 0) return;
+			for (std::size_t i = b; i < e; ++i) {
+				const int x = static_cast<int>(i % sx);
+				const int z = static_cast<int>((i / sx) % sz);
+				const int y = static_cast<int>(i / (static_cast<std::size_t>(sx) * sz));
+				chunk.setChannel(ch, x, y, z, v);
+			}
+		});
+		if (!ok) return false;
+	}
+	out = std::move(chunk);
+	return true;
+}
+
+} // namespace voxel
@@ -0,0 +1,20 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "chunk.hpp"
+
+namespace voxel {
+
+// Compact in-memory form of a chunk: shape and layout, block types as
+// (type, length) runs in linear order, then each allocated channel as
+// (value, length) runs. Lengths are LEB128 varints. Terrain is mostly long
+// runs of one block, so this is typically a few hundred bytes per section.
+// Not a file format: no magic, version or checksum.
+void encodeChunkRle(const Chunk& chunk, std::vector<std::uint8_t>& out);
+// Replace out with the chunk encoded in data. False (out untouched) when
+// the bytes are truncated or do not describe a whole chunk.
+bool decodeChunkRle(const std::uint8_t* data, std::size_t size, Chunk& out);
+
+} // namespace voxel
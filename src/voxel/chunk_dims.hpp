@@ -0,0 +1,72 @@
+#pragma once
+
+#include <bit>
+#include <cstddef>
+#include <utility>
+
+namespace voxel {
+
+// Compile-time chunk shape. All sizes are powers of two, so voxel indexing
+// and world->chunk coordinate splits become shifts and masks, and loops
+// bounded by sizeX/sizeY/sizeZ have constant trip counts.
+// Storage order is Y-major, then Z, then X (same as Chunk).
+template<int SX, int SY, int SZ>
+struct FixedChunkDims {
+	static_assert(std::has_single_bit(static_cast<unsigned>(SX))
+		&& std::has_single_bit(static_cast<unsigned>(SY))
+		&& std::has_single_bit(static_cast<unsigned>(SZ)), "chunk sizes must be powers of two");
+
+	static constexpr bool kFixed = true;
+	static constexpr int sizeX = SX;
+	static constexpr int sizeY = SY;
+	static constexpr int sizeZ = SZ;
+	static constexpr int shiftX = std::countr_zero(static_cast<unsigned>(SX));
+	static constexpr int shiftZ = std::countr_zero(static_cast<unsigned>(SZ));
+	static constexpr std::size_t volume = static_cast<std::size_t>(SX) * SY * SZ;
+
+	static constexpr std::size_t index(int x, int y, int z) {
+		return (static_cast<std::size_t>(y) << (shiftZ + shiftX))
+			| (static_cast<std::size_t>(z) << shiftX)
+			| static_cast<std::size_t>(x);
+	}
+};
+
+// Same interface for shapes without a prebuilt specialization.
+struct RuntimeChunkDims {
+	static constexpr bool kFixed = false;
+	int sizeX;
+	int sizeY;
+	int sizeZ;
+	std::size_t volume;
+
+	RuntimeChunkDims(int sx, int sy, int sz)
+		: sizeX(sx), sizeY(sy), sizeZ(sz), volume(static_cast<std::size_t>(sx) * sy * sz) {}
+
+	std::size_t index(int x, int y, int z) const {
+		return static_cast<std::size_t>((y * sizeZ + z) * sizeX + x);
+	}
+};
+
+// Invoke f with the prebuilt FixedChunkDims matching (sx,sy,sz), or with a
+// RuntimeChunkDims when the shape is not one of the specializations.
+// Hot loops written against the generic dims object get one instantiation
+// per specialization; config picks among them at startup.
+template<class F>
+decltype(auto) dispatchChunkDims(int sx, int sy, int sz, F&& f) {
+	if (sx == sy && sy == sz) {
+		switch (sx) {
+			case 8:  return std::forward<F>(f)(FixedChunkDims<8, 8, 8>{});
+			case 16: return std::forward<F>(f)(FixedChunkDims<16, 16, 16>{});
+			case 32: return std::forward<F>(f)(FixedChunkDims<32, 32, 32>{});
+			case 64: return std::forward<F>(f)(FixedChunkDims<64, 64, 64>{});
+			default: break;
+		}
+	}
+	return std::forward<F>(f)(RuntimeChunkDims{sx, sy, sz});
+}
+
+inline bool hasFixedChunkDims(int sx, int sy, int sz) {
+	return dispatchChunkDims(sx, sy, sz, [](auto dims) { return decltype(dims)::kFixed; });
+}
+
+} // namespace voxel
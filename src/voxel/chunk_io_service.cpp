@@ -0,0 +1,331 @@
+#include "chunk_io_service.hpp"
+#include "../config/config.hpp"
+#include "../core/debug_counters.hpp"
+#include "chunk_map.hpp"
+
+#include <algorithm>
+#include <filesystem>
+#include <unordered_set>
+
+namespace voxel {
+
+// Region files the worker keeps open at once before dropping its handles
+static constexpr std::size_t kMaxOpenRegions = 64;
+
+static std::uint64_t regionKey(int cx, int cy, int cz) {
+	return packChunkKey(regionCoord(cx), cy, regionCoord(cz));
+}
+
+ChunkIoService::ChunkIoService(std::string saveDir, std::size_t queueCapacity)
+	: saveDir_(std::move(saveDir)), capacity_(std::max<std::size_t>(1, queueCapacity)) {
+	std::error_code ec;
+	std::filesystem::create_directories(saveDir_, ec);
+	worker_ = std::thread([this] { run(); });
+}
+
+ChunkIoService::~ChunkIoService() {
+	std::vector<std::shared_ptr<Request>> waiting;
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		// Write-behind saves still waiting for room are not dropped
+		for (auto& r : backlog_) queue_.push_back(std::move(r));
+		backlog_.clear();
+		stopping_ = true;
+	}
+	wake_.notify_all();
+	worker_.join();
+	for (auto& r : queue_) waiting.push_back(r);
+	for (auto& r : done_) waiting.push_back(r);
+	queue_.clear();
+	done_.clear();
+	for (auto& r : waiting) {
+		std::vector<std::coroutine_handle<>> waiters = std::move(r->waiters);
+		for (std::coroutine_handle<> h : waiters) h.destroy();
+	}
+	core::debugCounters().ioPending = 0;
+}
+
+std::shared_ptr<ChunkIoService::Request> ChunkIoService::makeLoad(int cx, int cy, int cz) const {
+	auto req = std::make_shared<Request>();
+	req->cx = cx; req->cy = cy; req->cz = cz;
+	const auto& dims = config::Config::instance().chunk();
+	req->sizeX = dims.sizeX;
+	req->sizeY = dims.sizeY;
+	req->sizeZ = dims.sizeZ;
+	req->layout = parseChunkLayout(dims.layout);
+	return req;
+}
+
+ChunkIoService::LoadAwaiter ChunkIoService::load(int cx, int cy, int cz) {
+	return LoadAwaiter(*this, makeLoad(cx, cy, cz));
+}
+
+std::optional<Chunk> ChunkIoService::loadNow(int cx, int cy, int cz) {
+	std::shared_ptr<Request> req = makeLoad(cx, cy, cz);
+	std::unique_lock<std::mutex> lock(mutex_);
+	// Jump the capacity bound rather than the order: everything already
+	// submitted (saves of this section included) is ahead of it
+	for (auto& r : backlog_) queue_.push_back(std::move(r));
+	backlog_.clear();
+	queue_.push_back(req);
+	publishPending();
+	wake_.notify_one();
+	idle_.wait(lock, [&] { return req->finished; });
+	return std::move(req->loaded);
+}
+
+ChunkIoService::SaveAwaiter ChunkIoService::save(int cx, int cy, int cz, std::shared_ptr<const Chunk> snapshot) {
+	auto req = std::make_shared<Request>();
+	req->save = true;
+	req->cx = cx; req->cy = cy; req->cz = cz;
+	req->snapshot = std::move(snapshot);
+	return SaveAwaiter(*this, std::move(req));
+}
+
+void ChunkIoService::writeBehind(int cx, int cy, int cz, std::shared_ptr<const Chunk> snapshot) {
+	auto req = std::make_shared<Request>();
+	req->save = true;
+	req->cx = cx; req->cy = cy; req->cz = cz;
+	req->snapshot = std::move(snapshot);
+	submit(std::move(req));
+}
+
+void ChunkIoService::LoadAwaiter::await_suspend(std::coroutine_handle<> h) {
+	req_->waiters.push_back(h);
+	req_ = io_.submit(std::move(req_));
+}
+
+std::optional<Chunk> ChunkIoService::LoadAwaiter::await_resume() {
+	return std::move(req_->loaded);
+}
+
+void ChunkIoService::SaveAwaiter::await_suspend(std::coroutine_handle<> h) {
+	req_->waiters.push_back(h);
+	req_ = io_.submit(std::move(req_));
+}
+
+bool ChunkIoService::SaveAwaiter::await_resume() const {
+	return req_->ok;
+}
+
+std::shared_ptr<ChunkIoService::Request> ChunkIoService::submit(std::shared_ptr<Request> req) {
+	bool queued = false;
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		if (req->save) {
+			const std::uint64_t key = packChunkKey(req->cx, req->cy, req->cz);
+			auto it = queuedSaves_.find(key);
+			if (it != queuedSaves_.end()) {
+				// Still queued: write the newer snapshot once for everyone
+				std::shared_ptr<Request> merged = it->second;
+				merged->snapshot = std::move(req->snapshot);
+				merged->waiters.insert(merged->waiters.end(), req->waiters.begin(), req->waiters.end());
+				return merged;
+			}
+			queuedSaves_.emplace(key, req);
+		}
+		if (backlog_.empty() && queue_.size() < capacity_) {
+			queue_.push_back(req);
+			queued = true;
+		} else {
+			backlog_.push_back(req);
+		}
+		publishPending();
+	}
+	if (queued) wake_.notify_one();
+	return req;
+}
+
+void ChunkIoService::fillQueue() {
+	bool moved = false;
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		while (!backlog_.empty() && queue_.size() < capacity_) {
+			queue_.push_back(std::move(backlog_.front()));
+			backlog_.pop_front();
+			moved = true;
+		}
+	}
+	if (moved) wake_.notify_one();
+}
+
+void ChunkIoService::publishPending() const {
+	core::debugCounters().ioPending = queue_.size() + backlog_.size() + busy_ + done_.size();
+}
+
+std::size_t ChunkIoService::poll(std::size_t maxResumes) {
+	fillQueue();
+	std::vector<std::coroutine_handle<>> ready;
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		std::size_t taken = 0;
+		while (taken < done_.size() && ready.size() < maxResumes) {
+			std::vector<std::coroutine_handle<>>& w = done_[taken]->waiters;
+			ready.insert(ready.end(), w.begin(), w.end());
+			w.clear();
+			++taken;
+		}
+		done_.erase(done_.begin(), done_.begin() + static_cast<std::ptrdiff_t>(taken));
+		publishPending();
+	}
+	// Resumed coroutines may submit more requests; the lock is not held
+	for (std::coroutine_handle<> h : ready) h.resume();
+	return ready.size();
+}
+
+std::size_t ChunkIoService::pending() const {
+	std::lock_guard<std::mutex> lock(mutex_);
+	return queue_.size() + backlog_.size() + busy_ + done_.size();
+}
+
+bool ChunkIoService::drain() {
+	bool retried = false;
+	for (;;) {
+		{
+			std::unique_lock<std::mutex> lock(mutex_);
+			for (auto& r : backlog_) queue_.push_back(std::move(r));
+			backlog_.clear();
+			if (unsaved_ != 0 && !retried) {
+				auto retry = std::make_shared<Request>();
+				retry->retry = true;
+				queue_.push_back(std::move(retry));
+				retried = true;
+			}
+			wake_.notify_one();
+			idle_.wait(lock, [&] { return queue_.empty() && busy_ == 0; });
+			if (done_.empty()) return unsaved_ == 0;
+		}
+		poll();
+	}
+}
+
+void ChunkIoService::run() {
+	std::unique_lock<std::mutex> lock(mutex_);
+	for (;;) {
+		wake_.wait(lock, [&] { return stopping_ || !queue_.empty(); });
+		if (queue_.empty()) break;
+		std::vector<std::shared_ptr<Request>> batch(queue_.begin(), queue_.end());
+		queue_.clear();
+		for (const auto& r : batch) {
+			if (!r->save) continue;
+			auto it = queuedSaves_.find(packChunkKey(r->cx, r->cy, r->cz));
+			if (it != queuedSaves_.end() && it->second == r) queuedSaves_.erase(it);
+		}
+		busy_ = batch.size();
+		lock.unlock();
+		const std::size_t unsaved = process(batch);
+		lock.lock();
+		busy_ = 0;
+		unsaved_ = unsaved;
+		for (auto& r : batch) {
+			r->finished = true;
+			if (!r->waiters.empty()) done_.push_back(std::move(r));
+		}
+		publishPending();
+		idle_.notify_all();
+	}
+}
+
+RegionFile* ChunkIoService::region(int cx, int cy, int cz, bool create) {
+	const std::uint64_t key = regionKey(cx, cy, cz);
+	auto it = regions_.find(key);
+	if (it != regions_.end() && (it->second || !create)) return it->second.get();
+	auto file = std::make_unique<RegionFile>();
+	if (!file->open(regionFilePath(saveDir_, cx, cy, cz), create)) file.reset();
+	// A region whose staged writes fail to flush stays open to keep them
+	if (it == regions_.end() && regions_.size() >= kMaxOpenRegions) {
+		for (auto r = regions_.begin(); r != regions_.end();) {
+			if (!r->second || r->second->flush()) r = regions_.erase(r);
+			else ++r;
+		}
+	}
+	return (regions_[key] = std::move(file)).get();
+}
+
+bool ChunkIoService::stage(int cx, int cy, int cz, const Chunk& c) {
+	const bool empty = c.isUniform() && c.uniformType() == BlockType::Air;
+	RegionFile* f = region(cx, cy, cz, !empty);
+	if (empty) {
+		if (f) f->erase(regionLocal(cx), regionLocal(cz));
+		return true;
+	}
+	if (!f) return false;
+	c.saveToBuffer(buffer_);
+	f->write(regionLocal(cx), regionLocal(cz), buffer_.data(), buffer_.size());
+	return true;
+}
+
+std::size_t ChunkIoService::process(std::vector<std::shared_ptr<Request>>& batch) {
+	core::DebugCounters& dc = core::debugCounters();
+	// Saves kept from earlier batches go first, so newer ones replace them
+	for (auto it = unstaged_.begin(); it != unstaged_.end();) {
+		const std::uint64_t key = it->first;
+		if (stage(chunkKeyX(key), chunkKeyY(key), chunkKeyZ(key), *it->second)) it = unstaged_.erase(it);
+		else ++it;
+	}
+	// Saves before loads, so a load in the same batch reads what was just
+	// saved. Callers only load sections they do not hold, so the newest
+	// data is what they want.
+	for (const auto& r : batch) {
+		if (!r->save) continue;
+		const std::uint64_t key = packChunkKey(r->cx, r->cy, r->cz);
+		r->ok = stage(r->cx, r->cy, r->cz, *r->snapshot);
+		if (r->ok) {
+			unstaged_.erase(key);
+			// Let the chunk's next write reuse its body instead of cloning it
+			r->snapshot.reset();
+		} else {
+			unstaged_[key] = std::move(r->snapshot);
+		}
+		++dc.ioSaves;
+	}
+	// One flush per region: its new payloads go out in as few writes as
+	// their placement allows. One that fails keeps them staged, to be
+	// flushed again with the next batch.
+	std::unordered_set<std::uint64_t> failed;
+	for (auto& kv : regions_) {
+		if (kv.second && kv.second->hasPending() && !kv.second->flush()) failed.insert(kv.first);
+	}
+	for (const auto& r : batch) {
+		if (r->save && r->ok && failed.count(regionKey(r->cx, r->cy, r->cz))) r->ok = false;
+	}
+
+	// Loads, one readBatch per region; a section with a kept save loads that
+	std::unordered_map<std::uint64_t, std::vector<Request*>> byRegion;
+	for (const auto& r : batch) {
+		if (r->save || r->retry) continue;
+		auto kept = unstaged_.find(packChunkKey(r->cx, r->cy, r->cz));
+		if (kept == unstaged_.end()) {
+			byRegion[regionKey(r->cx, r->cy, r->cz)].push_back(r.get());
+			continue;
+		}
+		r->loaded.emplace(*kept->second);
+		r->ok = true;
+		++dc.ioLoads;
+	}
+	std::vector<RegionRead> reads;
+	for (auto& kv : byRegion) {
+		const Request& first = *kv.second.front();
+		RegionFile* f = region(first.cx, first.cy, first.cz, false);
+		if (f) {
+			reads.clear();
+			for (Request* r : kv.second) reads.push_back(RegionRead{ regionLocal(r->cx), regionLocal(r->cz), &r->bytes, false });
+			dc.ioReads += f->readBatch(reads.data(), reads.size());
+			for (std::size_t i = 0; i < reads.size(); ++i) {
+				Request& r = *kv.second[i];
+				if (reads[i].found) {
+					Chunk chunk(r.sizeX, r.sizeY, r.sizeZ, BlockType::Air, r.layout);
+					if (chunk.loadFromBuffer(r.bytes.data(), r.bytes.size())) r.loaded.emplace(std::move(chunk));
+				}
+				std::vector<std::uint8_t>().swap(r.bytes);
+			}
+		}
+		for (Request* r : kv.second) {
+			r->ok = r->loaded.has_value();
+			++dc.ioLoads;
+		}
+	}
+	return unstaged_.size() + failed.size();
+}
+
+} // namespace voxel
@@ -0,0 +1,159 @@
+#pragma once
+
+#include <condition_variable>
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include "chunk.hpp"
+#include "region_file.hpp"
+
+namespace voxel {
+
+// Return type for fire-and-forget coroutines that co_await the service.
+// The coroutine starts at once and frees its own frame when it finishes.
+struct IoTask {
+	struct promise_type {
+		IoTask get_return_object() noexcept { return {}; }
+		std::suspend_never initial_suspend() noexcept { return {}; }
+		std::suspend_never final_suspend() noexcept { return {}; }
+		void return_void() noexcept {}
+		void unhandled_exception() noexcept { std::terminate(); }
+	};
+};
+
+// Background thread that loads and saves sections in region files.
+//
+//   IoTask stream(ChunkIoService& io, int cx, int cy, int cz) {
+//       std::optional<Chunk> c = co_await io.load(cx, cy, cz);
+//       ...
+//   }
+//
+// Awaiting coroutines are resumed on the thread that calls poll(), once
+// per frame, never on the worker. The worker's queue holds at most
+// queueCapacity requests; the rest wait on the caller's side and move over
+// as poll() finds room, so submitting never blocks. The worker takes its
+// whole queue as one batch: saves are encoded from their snapshots and
+// written behind, one flush per region, then loads are grouped by region
+// and read with RegionFile::readBatch. A save that cannot be written is
+// kept (and loads of its section see it) and retried with every batch.
+class ChunkIoService {
+	struct Request;
+
+public:
+	explicit ChunkIoService(std::string saveDir, std::size_t queueCapacity = 256);
+	// Finishes queued saves. Coroutines still waiting are destroyed, not
+	// resumed; drain() first to let them run.
+	~ChunkIoService();
+	ChunkIoService(const ChunkIoService&) = delete;
+	ChunkIoService& operator=(const ChunkIoService&) = delete;
+
+	class LoadAwaiter {
+	public:
+		bool await_ready() const noexcept { return false; }
+		void await_suspend(std::coroutine_handle<> h);
+		// The saved section, or nullopt when none was saved or it did not decode
+		std::optional<Chunk> await_resume();
+	private:
+		friend class ChunkIoService;
+		LoadAwaiter(ChunkIoService& io, std::shared_ptr<Request> req) : io_(io), req_(std::move(req)) {}
+		ChunkIoService& io_;
+		std::shared_ptr<Request> req_;
+	};
+
+	class SaveAwaiter {
+	public:
+		bool await_ready() const noexcept { return false; }
+		void await_suspend(std::coroutine_handle<> h);
+		// True once the section is written (or, for all air, removed)
+		bool await_resume() const;
+	private:
+		friend class ChunkIoService;
+		SaveAwaiter(ChunkIoService& io, std::shared_ptr<Request> req) : io_(io), req_(std::move(req)) {}
+		ChunkIoService& io_;
+		std::shared_ptr<Request> req_;
+	};
+
+	// Loaded chunks take the configured chunk dimensions and layout
+	[[nodiscard]] LoadAwaiter load(int cx, int cy, int cz);
+	// The snapshot is encoded on the worker; the live chunk stays editable
+	[[nodiscard]] SaveAwaiter save(int cx, int cy, int cz, std::shared_ptr<const Chunk> snapshot);
+	// Load on the calling thread's behalf and block until done, for callers
+	// that cannot wait a frame. Runs after every request submitted before it.
+	std::optional<Chunk> loadNow(int cx, int cy, int cz);
+	// Save without waiting. A queued save of the same section that the
+	// worker has not picked up yet is replaced rather than written twice.
+	void writeBehind(int cx, int cy, int cz, std::shared_ptr<const Chunk> snapshot);
+
+	// Move waiting requests into the worker's queue and resume up to
+	// maxResumes finished coroutines on this thread. Returns how many ran.
+	std::size_t poll(std::size_t maxResumes = SIZE_MAX);
+	// Block until every request is finished and resume all waiters. False
+	// when some save is still not on disk after a last retry.
+	bool drain();
+	// Requests submitted and not yet finished
+	std::size_t pending() const;
+	const std::string& saveDirectory() const { return saveDir_; }
+
+private:
+	struct Request {
+		bool save {false};
+		// No section: just a batch, so kept saves are retried
+		bool retry {false};
+		int cx {0}, cy {0}, cz {0};
+		std::shared_ptr<const Chunk> snapshot;
+		// Load target shape, and what the worker made of it
+		int sizeX {0}, sizeY {0}, sizeZ {0};
+		ChunkLayout layout {ChunkLayout::Linear};
+		std::vector<std::uint8_t> bytes;
+		std::optional<Chunk> loaded;
+		bool ok {false};
+		bool finished {false};
+		std::vector<std::coroutine_handle<>> waiters;
+	};
+
+	std::string saveDir_;
+	std::size_t capacity_;
+	mutable std::mutex mutex_;
+	std::condition_variable wake_;
+	std::condition_variable idle_;
+	// Guarded by mutex_: the worker's bounded queue, requests waiting for
+	// room in it, finished requests with waiters, queued saves by section
+	// (for merging) and the size of the batch in progress
+	std::deque<std::shared_ptr<Request>> queue_;
+	std::deque<std::shared_ptr<Request>> backlog_;
+	std::vector<std::shared_ptr<Request>> done_;
+	std::unordered_map<std::uint64_t, std::shared_ptr<Request>> queuedSaves_;
+	std::size_t busy_ {0};
+	// Saves and regions not on disk after the last batch
+	std::size_t unsaved_ {0};
+	bool stopping_ {false};
+	// Worker thread only: open regions, and snapshots of the saves whose
+	// region could not be opened, by section
+	std::unordered_map<std::uint64_t, std::unique_ptr<RegionFile>> regions_;
+	std::unordered_map<std::uint64_t, std::shared_ptr<const Chunk>> unstaged_;
+	std::vector<std::uint8_t> buffer_;
+	std::thread worker_;
+
+	// Queue req (merging queued saves) and return the request that now
+	// carries it
+	std::shared_ptr<Request> submit(std::shared_ptr<Request> req);
+	std::shared_ptr<Request> makeLoad(int cx, int cy, int cz) const;
+	void fillQueue();
+	void publishPending() const;
+	void run();
+	// Returns the saves still not on disk
+	std::size_t process(std::vector<std::shared_ptr<Request>>& batch);
+	bool stage(int cx, int cy, int cz, const Chunk& c);
+	RegionFile* region(int cx, int cy, int cz, bool create);
+};
+
+} // namespace voxel
@@ -0,0 +1,102 @@
+#include "chunk_layout.hpp"
+
+#include <bit>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <tuple>
+
+namespace voxel {
+
+const char* toString(ChunkLayout layout) {
+	switch (layout) {
+		case ChunkLayout::Linear:   return "linear";
+		case ChunkLayout::Morton:   return "morton";
+		case ChunkLayout::Bricked4: return "bricked";
+	}
+	return "?";
+}
+
+ChunkLayout parseChunkLayout(const std::string& name) {
+	if (name == "morton") return ChunkLayout::Morton;
+	if (name == "bricked") return ChunkLayout::Bricked4;
+	return ChunkLayout::Linear;
+}
+
+bool layoutSupports(ChunkLayout layout, int sizeX, int sizeY, int sizeZ) {
+	// coords packs 10 bits per axis
+	if (sizeX > 1024 || sizeY > 1024 || sizeZ > 1024) return layout == ChunkLayout::Linear;
+	switch (layout) {
+		case ChunkLayout::Linear:
+			return true;
+		case ChunkLayout::Morton:
+			return std::has_single_bit(static_cast<unsigned>(sizeX))
+				&& std::has_single_bit(static_cast<unsigned>(sizeY))
+				&& std::has_single_bit(static_cast<unsigned>(sizeZ));
+		case ChunkLayout::Bricked4:
+			return sizeX % 4 == 0 && sizeY % 4 == 0 && sizeZ % 4 == 0;
+	}
+	return false;
+}
+
+// Interleave coordinate bits X, Z, Y from the lowest bit up. An axis that
+// runs out of bits (non-cubic shapes) simply stops contributing, so the
+// index stays dense in [0, volume).
+static void buildMorton(LayoutTable& t, int sx, int sy, int sz) {
+	const int bits[3] = {
+		std::countr_zero(static_cast<unsigned>(sx)),
+		std::countr_zero(static_cast<unsigned>(sy)),
+		std::countr_zero(static_cast<unsigned>(sz))
+	};
+	std::vector<std::uint32_t>* tables[3] = { &t.x, &t.y, &t.z };
+	const int order[3] = { 0, 2, 1 };
+	int out = 0;
+	for (int b = 0; b < 10; ++b) {
+		for (int a : order) {
+			if (b >= bits[a]) continue;
+			std::vector<std::uint32_t>& tbl = *tables[a];
+			for (std::size_t v = 0; v < tbl.size(); ++v) {
+				if (v & (std::size_t{1} << b)) tbl[v] |= 1u << out;
+			}
+			++out;
+		}
+	}
+}
+
+static void buildBricked4(LayoutTable& t, int sx, int, int sz) {
+	const std::uint32_t bricksX = static_cast<std::uint32_t>(sx / 4);
+	const std::uint32_t bricksZ = static_cast<std::uint32_t>(sz / 4);
+	for (std::uint32_t v = 0; v < t.x.size(); ++v) t.x[v] = (v >> 2) * 64 + (v & 3);
+	for (std::uint32_t v = 0; v < t.z.size(); ++v) t.z[v] = (v >> 2) * bricksX * 64 + (v & 3) * 4;
+	for (std::uint32_t v = 0; v < t.y.size(); ++v) t.y[v] = (v >> 2) * bricksZ * bricksX * 64 + (v & 3) * 16;
+}
+
+const LayoutTable* layoutTable(ChunkLayout layout, int sizeX, int sizeY, int sizeZ) {
+	if (layout == ChunkLayout::Linear || !layoutSupports(layout, sizeX, sizeY, sizeZ)) return nullptr;
+
+	static std::mutex mutex;
+	static std::map<std::tuple<int, int, int, int>, std::unique_ptr<LayoutTable>> cache;
+	std::lock_guard<std::mutex> lock(mutex);
+	auto& slot = cache[std::make_tuple(static_cast<int>(layout), sizeX, sizeY, sizeZ)];
+	if (!slot) {
+		auto t = std::make_unique<LayoutTable>();
+		t->x.assign(static_cast<std::size_t>(sizeX), 0);
+		t->y.assign(static_cast<std::size_t>(sizeY), 0);
+		t->z.assign(static_cast<std::size_t>(sizeZ), 0);
+		if (layout == ChunkLayout::Morton) buildMorton(*t, sizeX, sizeY, sizeZ);
+		else buildBricked4(*t, sizeX, sizeY, sizeZ);
+		t->coords.assign(static_cast<std::size_t>(sizeX) * sizeY * sizeZ, 0);
+		for (int y = 0; y < sizeY; ++y) {
+			for (int z = 0; z < sizeZ; ++z) {
+				for (int x = 0; x < sizeX; ++x) {
+					t->coords[t->index(x, y, z)] = static_cast<std::uint32_t>(x)
+						| (static_cast<std::uint32_t>(y) << 10) | (static_cast<std::uint32_t>(z) << 20);
+				}
+			}
+		}
+		slot = std::move(t);
+	}
+	return slot.get();
+}
+
+} // namespace voxel
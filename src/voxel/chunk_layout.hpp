@@ -0,0 +1,47 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace voxel {
+
+// Order in which a chunk's voxels are laid out in storage.
+// Linear:   Y-major, then Z, then X (the original layout).
+// Morton:   Z-order curve; neighbours on every axis usually share a cache
+//           line. Needs power-of-two sizes.
+// Bricked4: 4x4x4 bricks stored contiguously, bricks in linear order.
+//           Needs sizes that are multiples of 4.
+enum class ChunkLayout : std::uint8_t {
+	Linear,
+	Morton,
+	Bricked4
+};
+
+const char* toString(ChunkLayout layout);
+// Accepts "linear", "morton", "bricked"; unknown names map to Linear
+ChunkLayout parseChunkLayout(const std::string& name);
+bool layoutSupports(ChunkLayout layout, int sizeX, int sizeY, int sizeZ);
+
+// Addressing tables for a non-linear layout. Every supported layout is
+// separable, so the storage index is x[lx] + y[ly] + z[lz]: three loads and
+// two adds, no multiplies. coords maps a storage index back to its position
+// (x | y << 10 | z << 20) for walking voxels in storage order.
+struct LayoutTable {
+	std::vector<std::uint32_t> x;
+	std::vector<std::uint32_t> y;
+	std::vector<std::uint32_t> z;
+	std::vector<std::uint32_t> coords;
+
+	std::uint32_t index(int lx, int ly, int lz) const { return x[lx] + y[ly] + z[lz]; }
+	static int coordX(std::uint32_t c) { return static_cast<int>(c & 0x3FF); }
+	static int coordY(std::uint32_t c) { return static_cast<int>((c >> 10) & 0x3FF); }
+	static int coordZ(std::uint32_t c) { return static_cast<int>(c >> 20); }
+};
+
+// Shared, immutable tables for (layout, shape). Built once on first use and
+// kept for the process lifetime. Returns nullptr for Linear, which indexes
+// arithmetically, and for shapes the layout does not support.
+const LayoutTable* layoutTable(ChunkLayout layout, int sizeX, int sizeY, int sizeZ);
+
+} // namespace voxel
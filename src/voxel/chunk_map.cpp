@@ -0,0 +1,73 @@
+#include "chunk_map.hpp"
+
+namespace voxel {
+
+static constexpr std::size_t kInitialCapacity = 64;
+
+ChunkMap::ChunkMap() : slots_(kInitialCapacity), mask_(kInitialCapacity - 1) {}
+
+Chunk& ChunkMap::insert(std::uint64_t key, Chunk&& chunk) {
+	if (Chunk* existing = find(key)) return *existing;
+	// Keep load at or below 1/2 so probe runs stay short
+	if ((size_ + 1) * 2 > slots_.size()) grow();
+
+	Slot slot;
+	slot.key = key;
+	if (!freeSlab_.empty()) {
+		slot.slab = freeSlab_.back();
+		freeSlab_.pop_back();
+		slab_[slot.slab].emplace(std::move(chunk));
+	} else {
+		slot.slab = slab_.size();
+		slab_.emplace_back(std::move(chunk));
+	}
+	slot.chunk = &*slab_[slot.slab];
+	place(slot);
+	++size_;
+	return *slot.chunk;
+}
+
+bool ChunkMap::erase(std::uint64_t key) {
+	if (size_ == 0) return false;
+	std::size_t i = hashChunkKey(key) & mask_;
+	for (;; i = (i + 1) & mask_) {
+		if (!slots_[i].chunk) return false;
+		if (slots_[i].key == key) break;
+	}
+	slab_[slots_[i].slab].reset();
+	freeSlab_.push_back(slots_[i].slab);
+	slots_[i] = Slot{};
+	--size_;
+
+	// Backward-shift deletion: pull later members of the probe run into the
+	// hole so lookups never need tombstones
+	std::size_t hole = i;
+	for (std::size_t j = (i + 1) & mask_; slots_[j].chunk; j = (j + 1) & mask_) {
+		const std::size_t home = hashChunkKey(slots_[j].key) & mask_;
+		// Move j into the hole unless its home lies cyclically in (hole, j]
+		const bool homeInRange = (hole <= j) ? (home > hole && home <= j) : (home > hole || home <= j);
+		if (!homeInRange) {
+			slots_[hole] = slots_[j];
+			slots_[j] = Slot{};
+			hole = j;
+		}
+	}
+	return true;
+}
+
+void ChunkMap::grow() {
+	std::vector<Slot> old = std::move(slots_);
+	slots_.assign(old.size() * 2, Slot{});
+	mask_ = slots_.size() - 1;
+	for (const Slot& s : old) {
+		if (s.chunk) place(s);
+	}
+}
+
+void ChunkMap::place(const Slot& slot) {
+	std::size_t i = hashChunkKey(slot.key) & mask_;
+	while (slots_[i].chunk) i = (i + 1) & mask_;
+	slots_[i] = slot;
+}
+
+} // namespace voxel
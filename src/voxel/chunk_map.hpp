@@ -0,0 +1,114 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <optional>
+#include <vector>
+#include "chunk.hpp"
+
+namespace voxel {
+
+// Chunk (section) coordinate packed into one 64-bit key: 21 bits per axis,
+// cx in bits 42..62, cy in 21..41, cz in 0..20, each as raw two's complement
+// (no sign extension into the neighbouring field). Covers +-1M chunks per
+// axis; a coordinate outside that would alias one 2^21 chunks away, so
+// World and WorldManager reject them (chunkKeyInRange) before packing.
+inline constexpr int kChunkKeyBits = 21;
+inline constexpr std::uint64_t kChunkKeyMask = (1ull << kChunkKeyBits) - 1;
+inline constexpr int kChunkCoordMin = -(1 << (kChunkKeyBits - 1));
+inline constexpr int kChunkCoordMax = (1 << (kChunkKeyBits - 1)) - 1;
+
+inline bool chunkKeyInRange(int cx, int cy, int cz) {
+	// Shifted into [0, 2^21) as unsigned, one compare per axis
+	constexpr std::uint32_t bias = 1u << (kChunkKeyBits - 1);
+	return static_cast<std::uint32_t>(cx) + bias <= kChunkKeyMask
+		&& static_cast<std::uint32_t>(cy) + bias <= kChunkKeyMask
+		&& static_cast<std::uint32_t>(cz) + bias <= kChunkKeyMask;
+}
+
+inline std::uint64_t packChunkKey(int cx, int cy, int cz) {
+	return ((static_cast<std::uint64_t>(static_cast<std::uint32_t>(cx)) & kChunkKeyMask) << (2 * kChunkKeyBits))
+		| ((static_cast<std::uint64_t>(static_cast<std::uint32_t>(cy)) & kChunkKeyMask) << kChunkKeyBits)
+		| (static_cast<std::uint64_t>(static_cast<std::uint32_t>(cz)) & kChunkKeyMask);
+}
+// Sign-extend one 21-bit field back to int
+inline int unpackChunkKeyField(std::uint64_t key, int shift) {
+	return static_cast<int>(static_cast<std::int64_t>(key << (64 - kChunkKeyBits - shift)) >> (64 - kChunkKeyBits));
+}
+inline int chunkKeyX(std::uint64_t key) { return unpackChunkKeyField(key, 2 * kChunkKeyBits); }
+inline int chunkKeyY(std::uint64_t key) { return unpackChunkKeyField(key, kChunkKeyBits); }
+inline int chunkKeyZ(std::uint64_t key) { return unpackChunkKeyField(key, 0); }
+
+// splitmix64 finalizer: every key bit affects every hash bit, so nearby
+// and negative coordinates spread evenly over the table
+inline std::uint64_t hashChunkKey(std::uint64_t key) {
+	key ^= key >> 30;
+	key *= 0xBF58476D1CE4E5B9ull;
+	key ^= key >> 27;
+	key *= 0x94D049BB133111EBull;
+	key ^= key >> 31;
+	return key;
+}
+
+// Flat open-addressing table from packed chunk key to Chunk.
+// Slots are (key, pointer) pairs probed linearly in a power-of-two array.
+// Chunks themselves live in a slab with a free list, so there is no
+// per-chunk node allocation and pointers stay valid across rehashes until
+// the chunk is erased.
+class ChunkMap {
+public:
+	ChunkMap();
+	ChunkMap(const ChunkMap&) = delete;
+	ChunkMap& operator=(const ChunkMap&) = delete;
+
+	// Single probe sequence; nullptr when absent
+	Chunk* find(std::uint64_t key) {
+		if (size_ == 0) return nullptr;
+		for (std::size_t i = hashChunkKey(key) & mask_;; i = (i + 1) & mask_) {
+			const Slot& s = slots_[i];
+			if (!s.chunk) return nullptr;
+			if (s.key == key) return s.chunk;
+		}
+	}
+	const Chunk* find(std::uint64_t key) const { return const_cast<ChunkMap*>(this)->find(key); }
+
+	// Insert a chunk for key; returns the existing chunk if already present
+	Chunk& insert(std::uint64_t key, Chunk&& chunk);
+	bool erase(std::uint64_t key);
+
+	std::size_t size() const { return size_; }
+	std::size_t capacity() const { return slots_.size(); }
+
+	// Visit every resident chunk as f(key, chunk)
+	template<class F>
+	void forEach(F&& f) const {
+		for (const Slot& s : slots_) {
+			if (s.chunk) f(s.key, static_cast<const Chunk&>(*s.chunk));
+		}
+	}
+	template<class F>
+	void forEach(F&& f) {
+		for (Slot& s : slots_) {
+			if (s.chunk) f(s.key, *s.chunk);
+		}
+	}
+
+private:
+	struct Slot {
+		std::uint64_t key {0};
+		Chunk* chunk {nullptr};   // null marks an empty slot
+		std::size_t slab {0};     // owning slab entry, recycled on erase
+	};
+
+	std::vector<Slot> slots_;
+	std::size_t mask_ {0};
+	std::size_t size_ {0};
+	std::deque<std::optional<Chunk>> slab_;
+	std::vector<std::size_t> freeSlab_;
+
+	void grow();
+	void place(const Slot& slot);
+};
+
+} // namespace voxel
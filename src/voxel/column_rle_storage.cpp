@@ -0,0 +1,152 @@
+#include "column_rle_storage.hpp"
+#include "chunk.hpp"
+
+#include <algorithm>
+
+namespace voxel {
+
+ColumnRleStorage::ColumnRleStorage(int sizeX, int sizeY, int sizeZ, BlockType fill)
+	: sizeX_(sizeX), sizeY_(sizeY), sizeZ_(sizeZ) {
+	const std::size_t columns = static_cast<std::size_t>(sizeX) * sizeZ;
+	runs_.assign(columns, ColumnRun{ static_cast<std::uint16_t>(sizeY), fill });
+	starts_.resize(columns + 1);
+	for (std::size_t c = 0; c <= columns; ++c) starts_[c] = static_cast<std::uint32_t>(c);
+}
+
+ColumnRleStorage::ColumnRleStorage(const Chunk& chunk)
+	: sizeX_(chunk.sizeX()), sizeY_(chunk.sizeY()), sizeZ_(chunk.sizeZ()) {
+	std::vector<BlockType> types(static_cast<std::size_t>(sizeX_) * sizeY_ * sizeZ_);
+	chunk.copyTypes(types.data());
+	build(types.data());
+}
+
+void ColumnRleStorage::build(const BlockType* types) {
+	const std::size_t layer = static_cast<std::size_t>(sizeX_) * sizeZ_;
+	runs_.clear();
+	starts_.assign(layer + 1, 0);
+	for (int z = 0; z < sizeZ_; ++z) {
+		for (int x = 0; x < sizeX_; ++x) {
+			const std::size_t c = column(x, z);
+			starts_[c] = static_cast<std::uint32_t>(runs_.size());
+			BlockType t = types[c];
+			for (int y = 1; y < sizeY_; ++y) {
+				const BlockType n = types[static_cast<std::size_t>(y) * layer + c];
+				if (n == t) continue;
+				runs_.push_back(ColumnRun{ static_cast<std::uint16_t>(y), t });
+				t = n;
+			}
+			runs_.push_back(ColumnRun{ static_cast<std::uint16_t>(sizeY_), t });
+		}
+	}
+	starts_[layer] = static_cast<std::uint32_t>(runs_.size());
+	refreshUniform();
+}
+
+void ColumnRleStorage::refreshUniform() {
+	uniform_ = runs_.size() == starts_.size() - 1
+		&& std::all_of(runs_.begin(), runs_.end(), [&](const ColumnRun& r) { return r.type == runs_.front().type; });
+}
+
+BlockType ColumnRleStorage::get(int x, int y, int z) const {
+	// First run ending above y
+	const ColumnRun* r = std::upper_bound(columnBegin(x, z), columnEnd(x, z), y,
+		[](int v, const ColumnRun& run) { return v < static_cast<int>(run.end); });
+	return r->type;
+}
+
+void ColumnRleStorage::set(int x, int y, int z, BlockType t) {
+	if (get(x, y, z) == t) return;
+	// Rebuild the column with [y, y + 1) cut out of its run, merging equal
+	// neighbours so runs stay maximal
+	edit_.clear();
+	auto push = [&](int end, BlockType type) {
+		if (!edit_.empty() && edit_.back().type == type) edit_.back().end = static_cast<std::uint16_t>(end);
+		else edit_.push_back(ColumnRun{ static_cast<std::uint16_t>(end), type });
+	};
+	int y0 = 0;
+	for (const ColumnRun* r = columnBegin(x, z); r != columnEnd(x, z); ++r) {
+		if (y >= y0 && y < r->end) {
+			if (y > y0) push(y, r->type);
+			push(y + 1, t);
+			if (y + 1 < r->end) push(r->end, r->type);
+		} else {
+			push(r->end, r->type);
+		}
+		y0 = r->end;
+	}
+
+	// Splice the new runs in and shift the columns stored after this one
+	const std::size_t c = column(x, z);
+	const std::size_t oldCount = starts_[c + 1] - starts_[c];
+	const auto at = runs_.begin() + starts_[c];
+	if (edit_.size() > oldCount) {
+		runs_.insert(at + oldCount, edit_.size() - oldCount, ColumnRun{});
+	} else if (edit_.size() < oldCount) {
+		runs_.erase(at + edit_.size(), at + oldCount);
+	}
+	std::copy(edit_.begin(), edit_.end(), runs_.begin() + starts_[c]);
+	if (edit_.size() != oldCount) {
+		const std::int64_t delta = static_cast<std::int64_t>(edit_.size()) - static_cast<std::int64_t>(oldCount);
+		for (std::size_t i = c + 1; i < starts_.size(); ++i) {
+			starts_[i] = static_cast<std::uint32_t>(starts_[i] + delta);
+		}
+	}
+	refreshUniform();
+}
+
+int ColumnRleStorage::columnHeight(int x, int z) const {
+	// Top run is air or the column is solid to the top
+	const ColumnRun* begin = columnBegin(x, z);
+	const ColumnRun* top = columnEnd(x, z) - 1;
+	if (top->type != BlockType::Air) return sizeY_;
+	return top == begin ? 0 : static_cast<int>((top - 1)->end);
+}
+
+int ColumnRleStorage::minSolidY() const {
+	int lowest = -1;
+	for (int z = 0; z < sizeZ_; ++z) {
+		for (int x = 0; x < sizeX_; ++x) {
+			int y0 = 0;
+			for (const ColumnRun* r = columnBegin(x, z); r != columnEnd(x, z); ++r) {
+				if (r->type != BlockType::Air) {
+					if (lowest < 0 || y0 < lowest) lowest = y0;
+					break;
+				}
+				y0 = r->end;
+			}
+			if (lowest == 0) return 0;
+		}
+	}
+	return lowest;
+}
+
+int ColumnRleStorage::maxSolidY() const {
+	int highest = 0;
+	for (int z = 0; z < sizeZ_; ++z)
+		for (int x = 0; x < sizeX_; ++x) highest = std::max(highest, columnHeight(x, z));
+	return highest - 1;
+}
+
+void ColumnRleStorage::copyTypes(BlockType* out) const {
+	const std::size_t layer = static_cast<std::size_t>(sizeX_) * sizeZ_;
+	for (int z = 0; z < sizeZ_; ++z) {
+		for (int x = 0; x < sizeX_; ++x) {
+			BlockType* col = out + column(x, z);
+			forEachRun(x, z, [&](int y0, int y1, BlockType t) {
+				for (int y = y0; y < y1; ++y) col[static_cast<std::size_t>(y) * layer] = t;
+			});
+		}
+	}
+}
+
+void ColumnRleStorage::copyTo(Chunk& chunk) const {
+	std::vector<BlockType> types(static_cast<std::size_t>(sizeX_) * sizeY_ * sizeZ_);
+	copyTypes(types.data());
+	chunk.assignTypes(types.data());
+}
+
+std::size_t ColumnRleStorage::memoryUsage() const {
+	return runs_.capacity() * sizeof(ColumnRun) + starts_.capacity() * sizeof(std::uint32_t);
+}
+
+} // namespace voxel
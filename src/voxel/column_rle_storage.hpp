@@ -0,0 +1,88 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "voxel.hpp"
+
+namespace voxel {
+
+class Chunk;
+
+// One span of a column: voxels from the previous run's end (or 0) up to
+// end, exclusive, are all `type`
+struct ColumnRun {
+	std::uint16_t end;
+	BlockType type;
+};
+
+// Alternative voxel backend that keeps each (x, z) column as bottom-to-top
+// runs of one block type. Terrain columns are a handful of runs (stone,
+// dirt, air), so consumers that think in columns - heightmaps, the mesher's
+// unpack, lighting - touch one run instead of every voxel. Random edits
+// cost more than in Chunk: a run split shifts every run stored after it.
+// Holds block types only; there are no channels, snapshots or edit masks.
+class ColumnRleStorage {
+public:
+	ColumnRleStorage(int sizeX, int sizeY, int sizeZ, BlockType fill = BlockType::Air);
+	// Same contents as chunk, whatever its layout
+	explicit ColumnRleStorage(const Chunk& chunk);
+
+	int sizeX() const { return sizeX_; }
+	int sizeY() const { return sizeY_; }
+	int sizeZ() const { return sizeZ_; }
+
+	BlockType get(int x, int y, int z) const;
+	void set(int x, int y, int z, BlockType t);
+
+	// Runs of column (x, z), bottom to top; the last ends at sizeY
+	const ColumnRun* columnBegin(int x, int z) const { return runs_.data() + starts_[column(x, z)]; }
+	const ColumnRun* columnEnd(int x, int z) const { return runs_.data() + starts_[column(x, z) + 1]; }
+
+	// Visit the runs of column (x, z) as f(y0, y1, type) for [y0, y1)
+	template<class F>
+	void forEachRun(int x, int z, F&& f) const {
+		int y0 = 0;
+		for (const ColumnRun* r = columnBegin(x, z); r != columnEnd(x, z); ++r) {
+			f(y0, static_cast<int>(r->end), r->type);
+			y0 = r->end;
+		}
+	}
+
+	// Top solid y + 1, or 0 for an empty column, as Chunk::columnHeight
+	int columnHeight(int x, int z) const;
+	// Solid Y range over all columns, -1 for an empty chunk
+	int minSolidY() const;
+	int maxSolidY() const;
+	// Every column is one run of the same type
+	bool isUniform() const { return uniform_; }
+	BlockType uniformType() const { return runs_.front().type; }
+
+	// Copy all block types into out, indexed (y * sizeZ + z) * sizeX + x,
+	// writing each run as one strided span
+	void copyTypes(BlockType* out) const;
+	// Replace the block types of chunk, which must have the same shape, with
+	// these; channels are kept
+	void copyTo(Chunk& chunk) const;
+
+	std::size_t runCount() const { return runs_.size(); }
+	std::size_t memoryUsage() const;
+
+private:
+	int sizeX_ {0};
+	int sizeY_ {0};
+	int sizeZ_ {0};
+	// True while every column is a single run of one shared type
+	bool uniform_ {true};
+	// All columns' runs back to back; column c owns [starts_[c], starts_[c + 1])
+	std::vector<ColumnRun> runs_;
+	std::vector<std::uint32_t> starts_;
+	// Scratch for set(), reused between edits
+	std::vector<ColumnRun> edit_;
+
+	std::size_t column(int x, int z) const { return static_cast<std::size_t>(z) * sizeX_ + x; }
+	void build(const BlockType* types);
+	void refreshUniform();
+};
+
+} // namespace voxel
@@ -0,0 +1,205 @@
+#include "edit_journal.hpp"
+#include "../core/crc32c.hpp"
+#include "byte_io.hpp"
+#include "region_file.hpp"
+
+#include <filesystem>
+#include <fstream>
+
+#if defined(__linux__) || defined(__APPLE__)
+#include <unistd.h>
+#define VOXEL_POSIX_IO 1
+#endif
+
+namespace voxel {
+
+static constexpr std::uint32_t kJournalMagic = 0x564A4E4C; // 'VJNL'
+static constexpr std::uint32_t kJournalVersion = 1;
+static constexpr std::size_t kJournalHeaderBytes = 16;
+// Each batch: magic, payload bytes, crc32c of the payload. The payload is
+// a run count, then per run the position delta (zigzag varints), the
+// length and the old and new types.
+static constexpr std::uint32_t kBatchMagic = 0x564A4254; // 'VJBT'
+static constexpr std::size_t kBatchHeaderBytes = 12;
+
+static std::vector<std::uint8_t> readFile(const std::string& path) {
+	std::vector<std::uint8_t> bytes;
+	std::ifstream in(path, std::ios::binary | std::ios::ate);
+	if (!in) return bytes;
+	const std::streamoff size = in.tellg();
+	if (size <= 0) return bytes;
+	bytes.resize(static_cast<std::size_t>(size));
+	in.seekg(0);
+	if (!in.read(reinterpret_cast<char*>(bytes.data()), size)) bytes.clear();
+	return bytes;
+}
+
+static bool validHeader(const std::vector<std::uint8_t>& bytes) {
+	ByteReader in{ bytes.data(), bytes.data() + bytes.size() };
+	std::uint32_t magic = 0, version = 0;
+	return bytes.size() >= kJournalHeaderBytes && in.u32(magic) && in.u32(version)
+		&& magic == kJournalMagic && version == kJournalVersion;
+}
+
+// Calls f(payload) for each intact batch after the header; returns where
+// the intact batches end
+template<class F>
+static std::size_t forEachBatch(const std::vector<std::uint8_t>& bytes, F&& f) {
+	std::size_t at = kJournalHeaderBytes;
+	while (bytes.size() - at >= kBatchHeaderBytes) {
+		ByteReader in{ bytes.data() + at, bytes.data() + bytes.size() };
+		std::uint32_t magic = 0, size = 0, crc = 0;
+		in.u32(magic);
+		in.u32(size);
+		in.u32(crc);
+		if (magic != kBatchMagic || in.remaining() < size || core::crc32c(in.p, size) != crc) break;
+		f(ByteReader{ in.p, in.p + size });
+		at += kBatchHeaderBytes + size;
+	}
+	return at;
+}
+
+bool EditJournal::open(const std::string& path) {
+	close();
+	std::error_code ec;
+	// Shorter than a header: creating it was cut short, so start over
+	const bool exists = std::filesystem::exists(path, ec) && std::filesystem::file_size(path, ec) >= kJournalHeaderBytes;
+	std::size_t end = kJournalHeaderBytes;
+	if (exists) {
+		const std::vector<std::uint8_t> bytes = readFile(path);
+		if (!validHeader(bytes)) return false;
+		end = forEachBatch(bytes, [](ByteReader) {});
+		// Drop a torn batch so appends do not land behind it
+		if (end < bytes.size()) std::filesystem::resize_file(path, end, ec);
+		if (ec) return false;
+	}
+	path_ = path;
+	file_ = std::fopen(path.c_str(), exists ? "ab" : "wb");
+	if (!file_) return false;
+	bytes_ = end;
+	if (!exists) {
+		if (!writeHeader()) {
+			close();
+			return false;
+		}
+		// The new file's directory entry must survive a crash as well
+		const std::filesystem::path dir = std::filesystem::path(path).parent_path();
+		syncFile(dir.empty() ? "." : dir.string());
+	}
+	return true;
+}
+
+void EditJournal::close() {
+	if (!file_) return;
+	sync();
+	std::fclose(file_);
+	file_ = nullptr;
+	batch_.clear();
+	staged_ = 0;
+}
+
+void EditJournal::append(const JournalRun& run) {
+	if (run.length == 0) return;
+	if (staged_ == 0) {
+		firstStaged_ = std::chrono::steady_clock::now();
+		lastX_ = lastY_ = lastZ_ = 0;
+	}
+	putSignedVarint(batch_, static_cast<std::int64_t>(run.x) - lastX_);
+	putSignedVarint(batch_, static_cast<std::int64_t>(run.y) - lastY_);
+	putSignedVarint(batch_, static_cast<std::int64_t>(run.z) - lastZ_);
+	putVarint(batch_, run.length);
+	batch_.push_back(static_cast<std::uint8_t>(run.oldType));
+	batch_.push_back(static_cast<std::uint8_t>(run.newType));
+	lastX_ = run.x;
+	lastY_ = run.y;
+	lastZ_ = run.z;
+	++staged_;
+}
+
+bool EditJournal::sync() {
+	if (staged_ == 0) return true;
+	if (!file_) return false;
+	std::vector<std::uint8_t> count;
+	putVarint(count, staged_);
+	const std::uint32_t crc = core::crc32c(batch_.data(), batch_.size(), core::crc32c(count.data(), count.size()));
+	std::vector<std::uint8_t> head;
+	putU32(head, kBatchMagic);
+	putU32(head, static_cast<std::uint32_t>(count.size() + batch_.size()));
+	putU32(head, crc);
+	bool ok = std::fwrite(head.data(), 1, head.size(), file_) == head.size()
+		&& std::fwrite(count.data(), 1, count.size(), file_) == count.size()
+		&& std::fwrite(batch_.data(), 1, batch_.size(), file_) == batch_.size();
+	ok = flushToDisk() && ok;
+	if (!ok) {
+		// Cut off whatever part of the batch got out; it is retried whole
+		std::error_code ec;
+		std::filesystem::resize_file(path_, bytes_, ec);
+		return false;
+	}
+	bytes_ += head.size() + count.size() + batch_.size();
+	batch_.clear();
+	staged_ = 0;
+	++syncs_;
+	return true;
+}
+
+bool EditJournal::syncIfDue(std::chrono::milliseconds interval) {
+	if (staged_ == 0 || std::chrono::steady_clock::now() - firstStaged_ < interval) return true;
+	return sync();
+}
+
+std::vector<JournalRun> EditJournal::replay() const {
+	std::vector<JournalRun> runs;
+	if (path_.empty()) return runs;
+	const std::vector<std::uint8_t> bytes = readFile(path_);
+	if (!validHeader(bytes)) return runs;
+	forEachBatch(bytes, [&](ByteReader in) {
+		std::size_t count = 0;
+		if (!in.varint(count)) return;
+		std::int64_t x = 0, y = 0, z = 0;
+		for (std::size_t i = 0; i < count; ++i) {
+			std::int64_t dx = 0, dy = 0, dz = 0;
+			std::size_t length = 0;
+			std::uint8_t oldType = 0, newType = 0;
+			if (!in.signedVarint(dx) || !in.signedVarint(dy) || !in.signedVarint(dz) || !in.varint(length)
+				|| !in.byte(oldType) || !in.byte(newType)) return;
+			x += dx;
+			y += dy;
+			z += dz;
+			runs.push_back(JournalRun{ static_cast<int>(x), static_cast<int>(y), static_cast<int>(z),
+				static_cast<std::uint32_t>(length), static_cast<BlockType>(oldType), static_cast<BlockType>(newType) });
+		}
+	});
+	return runs;
+}
+
+bool EditJournal::reset() {
+	batch_.clear();
+	staged_ = 0;
+	if (!file_) return false;
+	file_ = std::freopen(path_.c_str(), "wb", file_);
+	if (!file_) return false;
+	bytes_ = 0;
+	return writeHeader();
+}
+
+bool EditJournal::writeHeader() {
+	std::vector<std::uint8_t> header;
+	putU32(header, kJournalMagic);
+	putU32(header, kJournalVersion);
+	header.resize(kJournalHeaderBytes, 0);
+	if (std::fwrite(header.data(), 1, header.size(), file_) != header.size() || !flushToDisk()) return false;
+	bytes_ = kJournalHeaderBytes;
+	return true;
+}
+
+bool EditJournal::flushToDisk() {
+	if (std::fflush(file_) != 0) return false;
+#if defined(VOXEL_POSIX_IO)
+	return fsync(fileno(file_)) == 0;
+#else
+	return true;
+#endif
+}
+
+} // namespace voxel
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+#include "voxel.hpp"
+
+namespace voxel {
+
+// One journaled change: length voxels from world position (x, y, z) along
+// +x, each of which went from oldType to newType
+struct JournalRun {
+	int x {0};
+	int y {0};
+	int z {0};
+	std::uint32_t length {0};
+	BlockType oldType {BlockType::Air};
+	BlockType newType {BlockType::Air};
+};
+
+// Append-only write-ahead log of voxel edits. Runs are staged in memory
+// and written by sync() as one checksummed batch followed by an fsync, so
+// the cost of durability is paid once per batch rather than per edit. A
+// batch cut short by a crash fails its checksum and is dropped on open,
+// along with anything after it.
+//
+// The journal holds every edit since the last checkpoint: once the edited
+// sections are saved and synced to their region files, reset() empties
+// it. On startup replay() yields what the region files do not have yet;
+// applying the runs' new types in order is idempotent. See
+// WorldManager::setJournal.
+class EditJournal {
+public:
+	EditJournal() = default;
+	// Syncs what is staged
+	~EditJournal() { close(); }
+	EditJournal(const EditJournal&) = delete;
+	EditJournal& operator=(const EditJournal&) = delete;
+
+	// Open the journal at path, creating it if missing. A torn tail is
+	// cut off. False when the file cannot be created or is not a journal.
+	bool open(const std::string& path);
+	void close();
+	bool isOpen() const { return file_ != nullptr; }
+	const std::string& path() const { return path_; }
+
+	// Stage a run; it is durable after the next sync()
+	void append(const JournalRun& run);
+	// Write the staged runs as one batch and force it to disk. False on
+	// an I/O error, in which case the runs stay staged.
+	bool sync();
+	// sync() once the oldest staged run has waited at least interval
+	bool syncIfDue(std::chrono::milliseconds interval);
+
+	// Every synced run, oldest first
+	std::vector<JournalRun> replay() const;
+	// Drop all runs, staged ones included, once they are checkpointed
+	bool reset();
+
+	// Bytes on disk, header included, and runs waiting for sync()
+	std::size_t size() const { return bytes_; }
+	std::size_t stagedRuns() const { return staged_; }
+	// Batches written since open
+	std::uint64_t syncCount() const { return syncs_; }
+
+private:
+	std::string path_;
+	std::FILE* file_ {nullptr};
+	std::size_t bytes_ {0};
+	// Encoded runs of the next batch; positions are deltas from the
+	// previous run in it
+	std::vector<std::uint8_t> batch_;
+	std::size_t staged_ {0};
+	int lastX_ {0}, lastY_ {0}, lastZ_ {0};
+	std::chrono::steady_clock::time_point firstStaged_ {};
+	std::uint64_t syncs_ {0};
+
+	bool writeHeader();
+	bool flushToDisk();
+};
+
+} // namespace voxel
@@ -0,0 +1,31 @@
+#include "edit_queue.hpp"
+#include <algorithm>
+
+namespace voxel {
+
+std::vector<SectionCoord> EditQueue::drain(World& world) {
+	std::vector<SectionCoord> out;
+	out.reserve(pending_.size());
+	for (const SectionCoord& sc : pending_) {
+		Chunk* c = world.findChunk(sc.cx, sc.cy, sc.cz);
+		if (!c) continue; // evicted since the edit
+		const std::uint8_t mask = c->takeEditMask();
+		// A repeat push finds the mask already taken
+		if (mask == 0) continue;
+		out.push_back(sc);
+		for (int axis = 0; axis < 3; ++axis) {
+			for (int dir = -1; dir <= 1; dir += 2) {
+				if (!(mask & editFaceBit(axis, dir))) continue;
+				int n[3] = { sc.cx, sc.cy, sc.cz };
+				n[axis] += dir;
+				if (world.hasChunk(n[0], n[1], n[2])) out.push_back(SectionCoord{ n[0], n[1], n[2] });
+			}
+		}
+	}
+	pending_.clear();
+	std::sort(out.begin(), out.end());
+	out.erase(std::unique(out.begin(), out.end()), out.end());
+	return out;
+}
+
+} // namespace voxel
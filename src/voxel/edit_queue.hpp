@@ -0,0 +1,28 @@
+#pragma once
+
+#include <vector>
+#include "world.hpp"
+
+namespace voxel {
+
+// Sections edited during a frame, drained once per frame. Pushing is cheap
+// and may repeat; the drain reads each chunk's edit mask to add the
+// neighbours whose shared border changed, so a held button or several
+// edits in one frame still remesh every affected section at most once.
+class EditQueue {
+public:
+	void push(int cx, int cy, int cz) {
+		const SectionCoord sc{ cx, cy, cz };
+		if (pending_.empty() || !(pending_.back() == sc)) pending_.push_back(sc);
+	}
+	bool empty() const { return pending_.empty(); }
+
+	// Edited sections still resident, plus resident face neighbours of
+	// every border they touched; sorted, each once. Takes the edit masks.
+	std::vector<SectionCoord> drain(World& world);
+
+private:
+	std::vector<SectionCoord> pending_;
+};
+
+} // namespace voxel
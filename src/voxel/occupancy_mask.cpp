@@ -0,0 +1,98 @@
+#include "occupancy_mask.hpp"
+#include "storage_pool.hpp"
+#include <algorithm>
+#include <bit>
+#include <utility>
+
+namespace voxel {
+
+OccupancyMask::OccupancyMask(std::size_t count, bool solid)
+	: count_(count), solid_(solid ? count : 0) {}
+
+OccupancyMask::~OccupancyMask() { collapse(); }
+
+OccupancyMask::OccupancyMask(const OccupancyMask& other)
+	: count_(other.count_), solid_(other.solid_), words_(storagePool().acquireCopy(other.words_)) {}
+
+OccupancyMask::OccupancyMask(OccupancyMask&& other) noexcept
+	: count_(other.count_), solid_(other.solid_), words_(std::move(other.words_)) {
+	other.words_ = {};
+	other.solid_ = 0;
+}
+
+OccupancyMask& OccupancyMask::operator=(const OccupancyMask& other) {
+	if (this == &other) return *this;
+	OccupancyMask copy(other);
+	return *this = std::move(copy);
+}
+
+OccupancyMask& OccupancyMask::operator=(OccupancyMask&& other) noexcept {
+	if (this == &other) return *this;
+	collapse();
+	count_ = other.count_;
+	solid_ = other.solid_;
+	words_ = std::move(other.words_);
+	other.words_ = {};
+	other.solid_ = 0;
+	return *this;
+}
+
+void OccupancyMask::expand() {
+	const std::size_t n = (count_ + 63) / 64;
+	words_ = storagePool().acquire(n);
+	if (solid_ == 0) return;
+	for (std::uint64_t& w : words_) w = ~0ull;
+	if (count_ & 63) words_[n - 1] = (1ull << (count_ & 63)) - 1ull;
+}
+
+void OccupancyMask::collapse() {
+	if (words_.capacity() != 0) storagePool().release(std::move(words_));
+	words_ = {};
+}
+
+void OccupancyMask::setRange(std::size_t begin, std::size_t end, bool solid) {
+	if (end > count_) end = count_;
+	if (begin >= end) return;
+	if (begin == 0 && end == count_) {
+		fill(solid);
+		return;
+	}
+	if (words_.empty()) {
+		if (solid == (solid_ != 0)) return;
+		expand();
+	}
+	while (begin < end) {
+		const std::size_t wi = begin >> 6;
+		const unsigned lo = static_cast<unsigned>(begin & 63);
+		const std::size_t n = std::min<std::size_t>(end - begin, 64 - lo);
+		const std::uint64_t m = (n == 64 ? ~0ull : ((1ull << n) - 1ull)) << lo;
+		std::uint64_t& w = words_[wi];
+		const std::size_t before = static_cast<std::size_t>(std::popcount(w & m));
+		if (solid) {
+			w |= m;
+			solid_ += n - before;
+		} else {
+			w &= ~m;
+			solid_ -= before;
+		}
+		begin += n;
+	}
+	if (solid_ == 0 || solid_ == count_) collapse();
+}
+
+void OccupancyMask::fill(bool solid) {
+	solid_ = solid ? count_ : 0;
+	collapse();
+}
+
+std::uint64_t OccupancyMask::bits(std::size_t i, int len) const {
+	const std::uint64_t mask = len >= 64 ? ~0ull : ((1ull << len) - 1ull);
+	if (words_.empty()) return solid_ != 0 ? mask : 0;
+	const std::size_t wi = i >> 6;
+	const unsigned lo = static_cast<unsigned>(i & 63);
+	std::uint64_t v = words_[wi] >> lo;
+	if (lo != 0 && lo + static_cast<unsigned>(len) > 64 && wi + 1 < words_.size()) v |= words_[wi + 1] << (64 - lo);
+	return v & mask;
+}
+
+} // namespace voxel
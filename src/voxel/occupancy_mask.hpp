@@ -0,0 +1,63 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace voxel {
+
+// One solid/air bit per voxel, in linear (y * sizeZ + z) * sizeX + x order
+// whatever the chunk's storage layout, plus a running solid count.
+// All-air and all-solid masks keep no words; the bits are materialized
+// from storagePool() the first time a voxel differs. A 32^3 chunk's
+// mask is 4 KiB, so whole-chunk solid queries stay in L1.
+class OccupancyMask {
+public:
+	explicit OccupancyMask(std::size_t count = 0, bool solid = false);
+	~OccupancyMask();
+	OccupancyMask(const OccupancyMask& other);
+	OccupancyMask(OccupancyMask&& other) noexcept;
+	OccupancyMask& operator=(const OccupancyMask& other);
+	OccupancyMask& operator=(OccupancyMask&& other) noexcept;
+
+	std::size_t size() const { return count_; }
+	std::size_t solidCount() const { return solid_; }
+	bool allAir() const { return solid_ == 0; }
+	bool allSolid() const { return solid_ == count_; }
+	// No per-voxel words are held (allAir() or allSolid())
+	bool isUniform() const { return words_.empty(); }
+
+	bool test(std::size_t i) const {
+		if (words_.empty()) return solid_ != 0;
+		return (words_[i >> 6] >> (i & 63)) & 1u;
+	}
+	void set(std::size_t i, bool solid) {
+		if (words_.empty()) {
+			if (solid == (solid_ != 0)) return;
+			expand();
+		}
+		std::uint64_t& w = words_[i >> 6];
+		const std::uint64_t bit = 1ull << (i & 63);
+		if (((w & bit) != 0) == solid) return;
+		w ^= bit;
+		if (solid) ++solid_; else --solid_;
+		if (solid_ == 0 || solid_ == count_) collapse();
+	}
+	void setRange(std::size_t begin, std::size_t end, bool solid);
+	void fill(bool solid);
+
+	// len (<= 64) bits starting at voxel i, bit 0 = voxel i
+	std::uint64_t bits(std::size_t i, int len) const;
+
+	std::size_t memoryUsage() const { return words_.capacity() * sizeof(std::uint64_t); }
+
+private:
+	std::size_t count_ {0};
+	std::size_t solid_ {0};
+	std::vector<std::uint64_t> words_;
+
+	void expand();
+	void collapse();
+};
+
+} // namespace voxel
@@ -0,0 +1,202 @@
+#include "palette_storage.hpp"
+#include "storage_pool.hpp"
+#include <utility>
+
+namespace voxel {
+
+static std::size_t wordsFor(std::size_t count, int bits) {
+	return (count * static_cast<std::size_t>(bits) + 63) / 64;
+}
+
+PaletteStorage::PaletteStorage(std::size_t count, BlockType fill)
+	: count_(count), uniform_(fill) {}
+
+PaletteStorage::~PaletteStorage() { releaseWords(); }
+
+// Copies (a snapshot's body being cloned) take their words from the pool too
+PaletteStorage::PaletteStorage(const PaletteStorage& other)
+	: count_(other.count_), bits_(other.bits_), mask_(other.mask_), uniform_(other.uniform_),
+	  paletteCount_(other.paletteCount_), palette_(other.palette_), refCounts_(other.refCounts_),
+	  words_(storagePool().acquireCopy(other.words_)) {}
+
+PaletteStorage::PaletteStorage(PaletteStorage&& other) noexcept
+	: count_(other.count_), bits_(other.bits_), mask_(other.mask_), uniform_(other.uniform_),
+	  paletteCount_(other.paletteCount_), palette_(other.palette_), refCounts_(other.refCounts_),
+	  words_(std::move(other.words_)) {
+	other.fill(other.uniform_);
+}
+
+PaletteStorage& PaletteStorage::operator=(const PaletteStorage& other) {
+	if (this == &other) return *this;
+	PaletteStorage copy(other);
+	return *this = std::move(copy);
+}
+
+PaletteStorage& PaletteStorage::operator=(PaletteStorage&& other) noexcept {
+	if (this == &other) return *this;
+	releaseWords();
+	count_ = other.count_;
+	bits_ = other.bits_;
+	mask_ = other.mask_;
+	uniform_ = other.uniform_;
+	paletteCount_ = other.paletteCount_;
+	palette_ = other.palette_;
+	refCounts_ = other.refCounts_;
+	words_ = std::move(other.words_);
+	other.fill(other.uniform_);
+	return *this;
+}
+
+void PaletteStorage::releaseWords() {
+	if (words_.capacity() != 0) storagePool().release(std::move(words_));
+	words_ = {};
+}
+
+void PaletteStorage::set(std::size_t i, BlockType t) {
+	if (bits_ == 0) {
+		if (t != uniform_) promote(i, t);
+		return;
+	}
+	if (direct()) {
+		writeIndex(i, static_cast<std::uint32_t>(t));
+		return;
+	}
+	const std::uint32_t old = readIndex(i);
+	if (palette_[old] == t) return;
+	const std::uint32_t slot = paletteSlotFor(t, old);
+	if (direct()) {
+		// Palette overflowed and storage switched to raw block types
+		writeIndex(i, static_cast<std::uint32_t>(t));
+		return;
+	}
+	if (slot == old) return; // sole user of the old slot, retargeted in place
+	--refCounts_[old];
+	if (++refCounts_[slot] == count_) {
+		fill(t); // every voxel is now the same type again
+		return;
+	}
+	writeIndex(i, slot);
+}
+
+void PaletteStorage::fillRange(std::size_t begin, std::size_t end, BlockType t) {
+	if (end > count_) end = count_;
+	if (begin >= end) return;
+	if (begin == 0 && end == count_) {
+		fill(t);
+		return;
+	}
+	if (bits_ == 0 && t == uniform_) return;
+	// The first write promotes or widens as needed; the rest reuse its slot
+	set(begin, t);
+	if (bits_ == 0) return; // became uniform, so the span already holds t
+	if (direct()) {
+		for (std::size_t i = begin + 1; i < end; ++i) writeIndex(i, static_cast<std::uint32_t>(t));
+		return;
+	}
+	const std::uint32_t slot = readIndex(begin);
+	for (std::size_t i = begin + 1; i < end; ++i) {
+		const std::uint32_t old = readIndex(i);
+		if (old == slot) continue;
+		--refCounts_[old];
+		++refCounts_[slot];
+		writeIndex(i, slot);
+	}
+	if (refCounts_[slot] == count_) fill(t);
+}
+
+bool PaletteStorage::mayContain(BlockType t) const {
+	if (bits_ == 0) return t == uniform_;
+	if (direct()) return true;
+	for (std::uint32_t s = 0; s < paletteCount_; ++s) {
+		if (palette_[s] == t && refCounts_[s] != 0) return true;
+	}
+	return false;
+}
+
+void PaletteStorage::decode(BlockType* out) const {
+	if (bits_ == 0) {
+		for (std::size_t i = 0; i < count_; ++i) out[i] = uniform_;
+		return;
+	}
+	const std::size_t perWord = static_cast<std::size_t>(64 / bits_);
+	std::size_t i = 0;
+	for (std::uint64_t w : words_) {
+		for (std::size_t k = 0; k < perWord && i < count_; ++k, ++i) {
+			const std::uint32_t idx = static_cast<std::uint32_t>(w & mask_);
+			out[i] = direct() ? static_cast<BlockType>(idx) : palette_[idx];
+			w >>= bits_;
+		}
+	}
+}
+
+void PaletteStorage::promote(std::size_t i, BlockType t) {
+	if (count_ == 1) {
+		uniform_ = t;
+		return;
+	}
+	bits_ = 1;
+	mask_ = 1;
+	paletteCount_ = 2;
+	palette_[0] = uniform_;
+	palette_[1] = t;
+	refCounts_[0] = static_cast<std::uint32_t>(count_ - 1);
+	refCounts_[1] = 1;
+	words_ = storagePool().acquire(wordsFor(count_, 1));
+	writeIndex(i, 1);
+}
+
+std::uint32_t PaletteStorage::paletteSlotFor(BlockType t, std::uint32_t replacing) {
+	const std::uint32_t n = paletteCount_;
+	for (std::uint32_t s = 0; s < n; ++s) {
+		if (palette_[s] == t) return s;
+	}
+	if (refCounts_[replacing] == 1) {
+		palette_[replacing] = t;
+		return replacing;
+	}
+	for (std::uint32_t s = 0; s < n; ++s) {
+		if (refCounts_[s] == 0) {
+			palette_[s] = t;
+			return s;
+		}
+	}
+	if (n >= (1u << bits_)) {
+		resize(bits_ * 2);
+		if (direct()) return 0;
+	}
+	palette_[n] = t;
+	refCounts_[n] = 0;
+	++paletteCount_;
+	return n;
+}
+
+void PaletteStorage::resize(int bits) {
+	const int oldBits = bits_;
+	const std::uint64_t oldMask = mask_;
+	std::vector<std::uint64_t> old = std::move(words_);
+	bits_ = bits;
+	mask_ = (1ull << bits) - 1ull;
+	words_ = storagePool().acquire(wordsFor(count_, bits));
+	for (std::size_t i = 0; i < count_; ++i) {
+		const std::size_t bit = i * static_cast<std::size_t>(oldBits);
+		std::uint32_t idx = static_cast<std::uint32_t>((old[bit >> 6] >> (bit & 63)) & oldMask);
+		if (direct()) idx = static_cast<std::uint32_t>(palette_[idx]);
+		writeIndex(i, idx);
+	}
+	storagePool().release(std::move(old));
+	if (direct()) paletteCount_ = 0;
+}
+
+void PaletteStorage::fill(BlockType t) {
+	bits_ = 0;
+	mask_ = 0;
+	uniform_ = t;
+	paletteCount_ = 0;
+	releaseWords();
+}
+
+std::size_t PaletteStorage::memoryUsage() const {
+	return words_.capacity() * sizeof(std::uint64_t);
+}
+
+} // namespace voxel
@@ -0,0 +1,92 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "voxel.hpp"
+
+namespace voxel {
+
+// Palette-compressed block storage for one chunk.
+// A chunk holding a single block type (all air, all stone) is uniform: one
+// value and no heap allocation at all. The first differing write promotes
+// it to indices into a small per-chunk palette, bit-packed at 1, 2 or 4
+// bits. Past 16 distinct types the storage switches to direct mode: 8 bits
+// per voxel holding the BlockType itself, with no palette.
+// Palette entries are reference counted so slots freed by overwrites are
+// reused before the index width has to grow, and a chunk whose voxels all
+// end up equal again drops back to uniform.
+// The palette lives inline and index words come from storagePool(), so
+// creating and dropping chunks does not touch the allocator once warm.
+class PaletteStorage {
+public:
+	explicit PaletteStorage(std::size_t count = 0, BlockType fill = BlockType::Air);
+	~PaletteStorage();
+	PaletteStorage(const PaletteStorage& other);
+	PaletteStorage(PaletteStorage&& other) noexcept;
+	PaletteStorage& operator=(const PaletteStorage& other);
+	PaletteStorage& operator=(PaletteStorage&& other) noexcept;
+
+	std::size_t size() const { return count_; }
+
+	BlockType get(std::size_t i) const {
+		if (bits_ == 0) return uniform_;
+		const std::uint32_t idx = readIndex(i);
+		return direct() ? static_cast<BlockType>(idx) : palette_[idx];
+	}
+	void set(std::size_t i, BlockType t);
+	// Set voxels [begin, end) to t. The palette slot is resolved once for
+	// the span; a span covering every voxel becomes uniform directly.
+	void fillRange(std::size_t begin, std::size_t end, BlockType t);
+	// False only when no voxel can hold t (lets edits skip whole chunks)
+	bool mayContain(BlockType t) const;
+
+	// Unpack all voxels into out[0..size()), a word at a time
+	void decode(BlockType* out) const;
+
+	// Reset every voxel to one type and release the index storage
+	void fill(BlockType t);
+
+	bool isUniform() const { return bits_ == 0; }
+	// Only meaningful when isUniform()
+	BlockType uniformValue() const { return uniform_; }
+
+	int bitsPerVoxel() const { return bits_; }
+	std::size_t paletteSize() const { return direct() ? 0 : paletteCount_; }
+	// Palette slot i < paletteSize(). A slot may be unused (no voxel left
+	// holding it), so this over-approximates the types present.
+	BlockType paletteEntry(std::size_t i) const { return palette_[i]; }
+	// Heap bytes held by the index words
+	std::size_t memoryUsage() const;
+
+private:
+	std::size_t count_ {0};
+	int bits_ {0};
+	std::uint64_t mask_ {0};
+	BlockType uniform_ {BlockType::Air};
+	// Widest palette is 4 bits; past that storage goes direct
+	static constexpr std::uint32_t kMaxPalette = 16;
+	std::uint32_t paletteCount_ {0};
+	std::array<BlockType, kMaxPalette> palette_{};
+	std::array<std::uint32_t, kMaxPalette> refCounts_{};
+	std::vector<std::uint64_t> words_;
+
+	bool direct() const { return bits_ == 8; }
+	std::uint32_t readIndex(std::size_t i) const {
+		const std::size_t bit = i * static_cast<std::size_t>(bits_);
+		return static_cast<std::uint32_t>((words_[bit >> 6] >> (bit & 63)) & mask_);
+	}
+	void writeIndex(std::size_t i, std::uint32_t idx) {
+		const std::size_t bit = i * static_cast<std::size_t>(bits_);
+		std::uint64_t& w = words_[bit >> 6];
+		const unsigned shift = static_cast<unsigned>(bit & 63);
+		w = (w & ~(mask_ << shift)) | (static_cast<std::uint64_t>(idx) << shift);
+	}
+	std::uint32_t paletteSlotFor(BlockType t, std::uint32_t replacing);
+	void promote(std::size_t i, BlockType t);
+	void resize(int bits);
+	void releaseWords();
+};
+
+} // namespace voxel
@@ -0,0 +1,334 @@
+#include "region_file.hpp"
+#include "byte_io.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+
+#if defined(__linux__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define VOXEL_POSIX_IO 1
+#endif
+
+namespace voxel {
+
+static constexpr std::uint32_t kRegionMagic = 0x5652474E; // 'VRGN'
+static constexpr std::uint32_t kRegionVersion = 1;
+static constexpr std::uint32_t kHeaderSectors = 3;
+static constexpr std::size_t kTableBytes = kRegionSlots * 2 * sizeof(std::uint32_t);
+static_assert(kTableBytes == 2 * kRegionSectorBytes, "offset table fills sectors 1-2");
+// readBatch reads across gaps up to this many sectors, and spans up to
+// kMaxSpanSectors, rather than issuing another read
+static constexpr std::uint32_t kCoalesceGapSectors = 4;
+static constexpr std::uint32_t kMaxSpanSectors = 256;
+
+std::string regionFilePath(const std::string& dir, int cx, int cy, int cz) {
+	return dir + "/region_" + std::to_string(regionCoord(cx)) + "_" + std::to_string(cy) + "_" + std::to_string(regionCoord(cz)) + ".vxr";
+}
+
+bool syncFile(const std::string& path) {
+#if defined(VOXEL_POSIX_IO)
+	const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+	if (fd < 0) return false;
+	const bool ok = fsync(fd) == 0;
+	::close(fd);
+	return ok;
+#else
+	// No portable way to force the data out; it is flushed to the OS
+	std::error_code ec;
+	return std::filesystem::exists(path, ec);
+#endif
+}
+
+bool RegionFile::open(const std::string& path, bool create) {
+	flush();
+	if (file_.is_open()) file_.close();
+	pending_.clear();
+	std::error_code ec;
+	if (!std::filesystem::exists(path, ec)) {
+		if (!create) return false;
+		std::vector<std::uint8_t> header;
+		putU32(header, kRegionMagic);
+		putU32(header, kRegionVersion);
+		header.resize(kHeaderSectors * kRegionSectorBytes, 0);
+		std::ofstream out(path, std::ios::binary);
+		if (!out.write(reinterpret_cast<const char*>(header.data()), static_cast<std::streamsize>(header.size())) || !out.flush()) return false;
+		// The new file and its directory entry must outlive a crash
+		out.close();
+		const std::string dir = std::filesystem::path(path).parent_path().string();
+		if (!syncFile(path) || !syncFile(dir.empty() ? "." : dir)) return false;
+	}
+
+	file_.open(path, std::ios::in | std::ios::out | std::ios::binary);
+	if (!file_) return false;
+	std::vector<std::uint8_t> header(kHeaderSectors * kRegionSectorBytes);
+	std::uint32_t magic = 0, version = 0;
+	if (file_.read(reinterpret_cast<char*>(header.data()), static_cast<std::streamsize>(header.size()))) {
+		ByteReader in{ header.data(), header.data() + header.size() };
+		in.u32(magic);
+		in.u32(version);
+	}
+	if (magic != kRegionMagic || version != kRegionVersion) {
+		file_.close();
+		return false;
+	}
+	file_.clear();
+	file_.seekg(0, std::ios::end);
+	const std::size_t fileSectors = static_cast<std::size_t>(file_.tellg()) / kRegionSectorBytes;
+
+	path_ = path;
+	used_.assign(std::max<std::size_t>(fileSectors, kHeaderSectors), false);
+	for (std::uint32_t s = 0; s < kHeaderSectors; ++s) used_[s] = true;
+	ByteReader table{ header.data() + kRegionSectorBytes, header.data() + header.size() };
+	for (Entry& e : table_) {
+		table.u32(e.sector);
+		table.u32(e.bytes);
+		// Entries pointing into the header or past the end are dropped
+		if (e.bytes == 0) continue;
+		if (e.sector < kHeaderSectors || e.sector + sectorsFor(e.bytes) > fileSectors) {
+			e = Entry{};
+			continue;
+		}
+		markSectors(e, true);
+	}
+	return true;
+}
+
+bool RegionFile::has(int lx, int lz) const {
+	const int s = slot(lx, lz);
+	auto it = pending_.find(s);
+	if (it != pending_.end()) return !it->second.empty();
+	return table_[s].bytes != 0;
+}
+
+bool RegionFile::read(int lx, int lz, std::vector<std::uint8_t>& out) {
+	const int s = slot(lx, lz);
+	auto it = pending_.find(s);
+	if (it != pending_.end()) {
+		out = it->second;
+		return !out.empty();
+	}
+	const Entry& e = table_[s];
+	if (e.bytes == 0 || !file_.is_open()) return false;
+	out.resize(e.bytes);
+	file_.clear();
+	file_.seekg(static_cast<std::streamoff>(e.sector) * kRegionSectorBytes);
+	return static_cast<bool>(file_.read(reinterpret_cast<char*>(out.data()), e.bytes));
+}
+
+std::size_t RegionFile::readBatch(RegionRead* reads, std::size_t count) {
+	std::vector<RegionRead*> disk;
+	for (std::size_t i = 0; i < count; ++i) {
+		RegionRead& r = reads[i];
+		const int s = slot(r.lx, r.lz);
+		if (pending_.count(s) || table_[s].bytes == 0 || !file_.is_open()) {
+			r.found = read(r.lx, r.lz, *r.out);
+			continue;
+		}
+		disk.push_back(&r);
+	}
+	auto entry = [&](const RegionRead* r) -> const Entry& { return table_[slot(r->lx, r->lz)]; };
+	std::sort(disk.begin(), disk.end(), [&](const RegionRead* a, const RegionRead* b) { return entry(a).sector < entry(b).sector; });
+
+	std::size_t calls = 0;
+	for (std::size_t i = 0; i < disk.size();) {
+		const std::uint32_t start = entry(disk[i]).sector;
+		std::uint32_t end = start + sectorsFor(entry(disk[i]).bytes);
+		std::size_t j = i + 1;
+		for (; j < disk.size(); ++j) {
+			const Entry& e = entry(disk[j]);
+			const std::uint32_t eEnd = e.sector + sectorsFor(e.bytes);
+			if (e.sector > end + kCoalesceGapSectors || std::max(end, eEnd) - start > kMaxSpanSectors) break;
+			end = std::max(end, eEnd);
+		}
+		span_.resize(static_cast<std::size_t>(end - start) * kRegionSectorBytes);
+		file_.clear();
+		file_.seekg(static_cast<std::streamoff>(start) * kRegionSectorBytes);
+		// The last payload may end short of its sector on a file written elsewhere
+		file_.read(span_.data(), static_cast<std::streamsize>(span_.size()));
+		const std::size_t got = static_cast<std::size_t>(file_.gcount());
+		++calls;
+		for (; i < j; ++i) {
+			const Entry& e = entry(disk[i]);
+			const std::size_t at = static_cast<std::size_t>(e.sector - start) * kRegionSectorBytes;
+			disk[i]->found = at + e.bytes <= got;
+			if (disk[i]->found) disk[i]->out->assign(span_.data() + at, span_.data() + at + e.bytes);
+		}
+	}
+	return calls;
+}
+
+void RegionFile::write(int lx, int lz, const std::uint8_t* data, std::size_t size) {
+	pending_[slot(lx, lz)].assign(data, data + size);
+}
+
+void RegionFile::erase(int lx, int lz) {
+	const int s = slot(lx, lz);
+	if (table_[s].bytes == 0 && !pending_.count(s)) return;
+	pending_[s].clear();
+}
+
+void RegionFile::markSectors(const Entry& e, bool used) {
+	const std::uint32_t n = sectorsFor(e.bytes);
+	for (std::uint32_t i = 0; i < n; ++i) used_[e.sector + i] = used;
+}
+
+std::uint32_t RegionFile::allocate(std::uint32_t sectors) {
+	// First fit among freed sectors, else grow the file (reusing any free tail)
+	std::size_t run = 0;
+	for (std::size_t i = kHeaderSectors; i < used_.size(); ++i) {
+		if (used_[i]) { run = 0; continue; }
+		if (++run == sectors) {
+			const std::size_t start = i + 1 - sectors;
+			for (std::size_t k = start; k <= i; ++k) used_[k] = true;
+			return static_cast<std::uint32_t>(start);
+		}
+	}
+	const std::size_t start = used_.size() - run;
+	used_.resize(start + sectors, false);
+	for (std::size_t k = start; k < used_.size(); ++k) used_[k] = true;
+	return static_cast<std::uint32_t>(start);
+}
+
+bool RegionFile::flush() {
+	if (pending_.empty() || !file_.is_open()) return true;
+
+	// Copy-on-write: new payloads go to sectors that are free now, while
+	// the ones they replace stay allocated. The old copies are released only
+	// once the table pointing away from them is on disk, so a crash at any
+	// point leaves each slot with its old or its new payload, never a torn one.
+	std::vector<int> slots;
+	slots.reserve(pending_.size());
+	Entry next[kRegionSlots];
+	std::memcpy(next, table_, sizeof(table_));
+	for (const auto& kv : pending_) {
+		slots.push_back(kv.first);
+		next[kv.first] = kv.second.empty() ? Entry{}
+			: Entry{ allocate(sectorsFor(kv.second.size())), static_cast<std::uint32_t>(kv.second.size()) };
+	}
+
+	// Write payloads in file order, one write per run of adjacent sectors
+	std::sort(slots.begin(), slots.end(), [&](int a, int b) { return next[a].sector < next[b].sector; });
+	std::vector<char> run;
+	std::uint32_t runStart = 0;
+	bool ok = true;
+	auto writeRun = [&]() {
+		if (run.empty()) return;
+		file_.clear();
+		file_.seekp(static_cast<std::streamoff>(runStart) * kRegionSectorBytes);
+		ok = static_cast<bool>(file_.write(run.data(), static_cast<std::streamsize>(run.size()))) && ok;
+		run.clear();
+	};
+	for (int s : slots) {
+		const Entry& e = next[s];
+		if (e.bytes == 0) continue;
+		if (!run.empty() && runStart + run.size() / kRegionSectorBytes != e.sector) writeRun();
+		if (run.empty()) runStart = e.sector;
+		const std::vector<std::uint8_t>& data = pending_[s];
+		const std::size_t at = run.size();
+		run.resize(at + sectorsFor(data.size()) * kRegionSectorBytes, 0);
+		std::memcpy(run.data() + at, data.data(), data.size());
+	}
+	writeRun();
+	// The payloads must be durable before the table points at them
+	ok = ok && static_cast<bool>(file_.flush()) && syncFile(path_);
+
+	if (ok) {
+		file_.clear();
+		file_.seekp(static_cast<std::streamoff>(kRegionSectorBytes));
+		std::vector<std::uint8_t> table;
+		table.reserve(kTableBytes);
+		for (const Entry& e : next) {
+			putU32(table, e.sector);
+			putU32(table, e.bytes);
+		}
+		ok = static_cast<bool>(file_.write(reinterpret_cast<const char*>(table.data()), kTableBytes))
+			&& static_cast<bool>(file_.flush()) && syncFile(path_);
+	}
+	if (!ok) {
+		// The table on disk may hold old or new entries; both payloads stay
+		// allocated (until the file is reopened) and the writes stay staged
+		// for another try
+		return false;
+	}
+	for (int s : slots) {
+		markSectors(table_[s], false);
+		table_[s] = next[s];
+	}
+	pending_.clear();
+	return true;
+}
+
+bool MappedRegion::open(const std::string& path) {
+	close();
+	const std::size_t header = kHeaderSectors * kRegionSectorBytes;
+#if defined(VOXEL_POSIX_IO)
+	const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+	if (fd < 0) return false;
+	struct stat st {};
+	void* map = MAP_FAILED;
+	if (fstat(fd, &st) == 0 && static_cast<std::size_t>(st.st_size) >= header) {
+		map = mmap(nullptr, static_cast<std::size_t>(st.st_size), PROT_READ, MAP_SHARED, fd, 0);
+	}
+	// The mapping keeps the file referenced
+	::close(fd);
+	if (map == MAP_FAILED) return false;
+	data_ = static_cast<const std::uint8_t*>(map);
+	size_ = static_cast<std::size_t>(st.st_size);
+	// Lookups hop between slots; readahead would fault in neighbours unasked
+	madvise(map, size_, MADV_RANDOM);
+#else
+	std::ifstream in(path, std::ios::binary | std::ios::ate);
+	if (!in) return false;
+	const std::streamoff size = in.tellg();
+	if (size < static_cast<std::streamoff>(header)) return false;
+	copy_.resize(static_cast<std::size_t>(size));
+	in.seekg(0);
+	if (!in.read(reinterpret_cast<char*>(copy_.data()), size)) {
+		std::vector<std::uint8_t>().swap(copy_);
+		return false;
+	}
+	data_ = copy_.data();
+	size_ = copy_.size();
+#endif
+	std::uint32_t magic = 0, version = 0;
+	ByteReader in{ data_, data_ + size_ };
+	in.u32(magic);
+	in.u32(version);
+	if (magic != kRegionMagic || version != kRegionVersion) {
+		close();
+		return false;
+	}
+	return true;
+}
+
+void MappedRegion::close() {
+	if (!data_) return;
+#if defined(VOXEL_POSIX_IO)
+	munmap(const_cast<std::uint8_t*>(data_), size_);
+#else
+	std::vector<std::uint8_t>().swap(copy_);
+#endif
+	data_ = nullptr;
+	size_ = 0;
+}
+
+const std::uint8_t* MappedRegion::payload(int lx, int lz, std::size_t& size) const {
+	size = 0;
+	if (!data_) return nullptr;
+	const std::size_t at = kRegionSectorBytes + static_cast<std::size_t>(lz * kRegionChunks + lx) * 2 * sizeof(std::uint32_t);
+	std::uint32_t sector = 0, bytes = 0;
+	ByteReader entry{ data_ + at, data_ + size_ };
+	entry.u32(sector);
+	entry.u32(bytes);
+	if (bytes == 0 || sector < kHeaderSectors) return nullptr;
+	const std::size_t begin = static_cast<std::size_t>(sector) * kRegionSectorBytes;
+	if (begin > size_ || bytes > size_ - begin) return nullptr;
+	size = bytes;
+	return data_ + begin;
+}
+
+} // namespace voxel
@@ -0,0 +1,136 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace voxel {
+
+// Sections per region side in X and Z. A region file holds one section
+// layer (a single cy) of kRegionChunks x kRegionChunks sections.
+inline constexpr int kRegionChunks = 32;
+inline constexpr int kRegionSlots = kRegionChunks * kRegionChunks;
+inline constexpr std::size_t kRegionSectorBytes = 4096;
+
+// Region containing section coordinate c, and c's slot within it
+inline int regionCoord(int c) { return c >= 0 ? c / kRegionChunks : -((-c - 1) / kRegionChunks) - 1; }
+inline int regionLocal(int c) { return c - regionCoord(c) * kRegionChunks; }
+// Region file under dir holding section (cx, cy, cz)
+std::string regionFilePath(const std::string& dir, int cx, int cy, int cz);
+// Force a file, or a directory's entries, to stable storage, whichever
+// handle wrote it. False when it cannot be opened or synced.
+bool syncFile(const std::string& path);
+
+// One slot of RegionFile::readBatch; found is set by the call
+struct RegionRead {
+	int lx {0};
+	int lz {0};
+	std::vector<std::uint8_t>* out {nullptr};
+	bool found {false};
+};
+
+// One file of many chunk payloads. Sector 0 holds the magic and version,
+// sectors 1-2 the offset table (per slot: first sector, byte length; zero
+// length is an empty slot), all little-endian u32s, then payloads each
+// start on a sector boundary.
+// The table lives in memory, so reading a slot is one seek and one read.
+// Writes are staged and land in flush(): payloads are placed first-fit in
+// free sectors, never over the payload they replace, and adjacent ones are
+// coalesced into single writes. They are synced before the table follows
+// in one write, which is synced in turn.
+class RegionFile {
+public:
+	RegionFile() = default;
+	RegionFile(const RegionFile&) = delete;
+	RegionFile& operator=(const RegionFile&) = delete;
+	~RegionFile() { flush(); }
+
+	// Open an existing region, or create an empty one when create is set.
+	// False when the file is missing (and !create) or not a region file.
+	bool open(const std::string& path, bool create);
+	bool isOpen() const { return file_.is_open(); }
+	const std::string& path() const { return path_; }
+
+	// Local slot coordinates are in [0, kRegionChunks)
+	bool has(int lx, int lz) const;
+	// Replace out with the slot's payload; false when the slot is empty
+	bool read(int lx, int lz, std::vector<std::uint8_t>& out);
+	// Read several slots at once. Payloads are visited in file order and
+	// those within a few sectors of each other share one read. Returns the
+	// number of reads issued.
+	std::size_t readBatch(RegionRead* reads, std::size_t count);
+	// Stage a payload for the slot, replacing what it holds
+	void write(int lx, int lz, const std::uint8_t* data, std::size_t size);
+	// Stage emptying the slot; its sectors become free on flush
+	void erase(int lx, int lz);
+
+	bool hasPending() const { return !pending_.empty(); }
+	// Write staged payloads and the table, durably. False on an I/O error;
+	// the file then still reads as before or as after, and the writes stay
+	// staged.
+	bool flush();
+
+	// File size in sectors, header included
+	std::size_t sectorCount() const { return used_.size(); }
+
+private:
+	struct Entry {
+		std::uint32_t sector {0};
+		std::uint32_t bytes {0};
+	};
+	std::fstream file_;
+	std::string path_;
+	Entry table_[kRegionSlots] {};
+	// One flag per sector of the file; header sectors are always used
+	std::vector<bool> used_;
+	// Staged payloads by slot; an empty vector stages an erase
+	std::unordered_map<int, std::vector<std::uint8_t>> pending_;
+	// Span buffer for readBatch
+	std::vector<char> span_;
+
+	static int slot(int lx, int lz) { return lz * kRegionChunks + lx; }
+	static std::uint32_t sectorsFor(std::size_t bytes) {
+		return static_cast<std::uint32_t>((bytes + kRegionSectorBytes - 1) / kRegionSectorBytes);
+	}
+	void markSectors(const Entry& e, bool used);
+	std::uint32_t allocate(std::uint32_t sectors);
+};
+
+// A region file mapped read-only. Payloads are returned as pointers into
+// the mapping, so nothing is copied and only the pages of slots actually
+// read are faulted in; the page cache is shared by every process mapping
+// the file. A RegionFile may write the file meanwhile: its table is re-read
+// on every lookup and payloads are checksummed, so a torn read fails to
+// decode. Growth past the mapped size is not seen until the next open().
+// Platforms without mmap read the whole file instead.
+class MappedRegion {
+public:
+	MappedRegion() = default;
+	MappedRegion(const MappedRegion&) = delete;
+	MappedRegion& operator=(const MappedRegion&) = delete;
+	~MappedRegion() { close(); }
+
+	// False when the file is missing or not a region file
+	bool open(const std::string& path);
+	void close();
+	bool isOpen() const { return data_ != nullptr; }
+
+	// Slot's payload within the mapping, or nullptr when the slot is empty
+	// (or points past the mapped end). Valid until close().
+	const std::uint8_t* payload(int lx, int lz, std::size_t& size) const;
+	bool has(int lx, int lz) const {
+		std::size_t size = 0;
+		return payload(lx, lz, size) != nullptr;
+	}
+	std::size_t mappedBytes() const { return size_; }
+
+private:
+	const std::uint8_t* data_ {nullptr};
+	std::size_t size_ {0};
+	std::vector<std::uint8_t> copy_;
+};
+
+} // namespace voxel
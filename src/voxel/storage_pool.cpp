@@ -0,0 +1,116 @@
+#include "storage_pool.hpp"
+#include <algorithm>
+#include <new>
+
+namespace voxel {
+
+StoragePool& storagePool() {
+	static StoragePool pool;
+	return pool;
+}
+
+std::vector<std::uint64_t> StoragePool::acquire(std::size_t words) {
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		for (SizeClass& c : classes_) {
+			if (c.words != words || c.free.empty()) continue;
+			std::vector<std::uint64_t> buffer = std::move(c.free.back());
+			c.free.pop_back();
+			stats_.pooledBytes -= words * sizeof(std::uint64_t);
+			++stats_.hits;
+			buffer.assign(words, 0);
+			return buffer;
+		}
+		++stats_.misses;
+	}
+	return std::vector<std::uint64_t>(words, 0);
+}
+
+std::vector<std::uint64_t> StoragePool::acquireCopy(const std::vector<std::uint64_t>& src) {
+	if (src.empty()) return {};
+	std::vector<std::uint64_t> buffer = acquire(src.size());
+	std::copy(src.begin(), src.end(), buffer.begin());
+	return buffer;
+}
+
+void StoragePool::release(std::vector<std::uint64_t>&& buffer) {
+	// Key on capacity: that is what the next acquire can reuse without growing
+	const std::size_t words = buffer.capacity();
+	if (words == 0) return;
+	const std::size_t bytes = words * sizeof(std::uint64_t);
+	std::lock_guard<std::mutex> lock(mutex_);
+	if (stats_.pooledBytes + bytes > retainLimit_) {
+		++stats_.dropped;
+		std::vector<std::uint64_t>().swap(buffer);
+		return;
+	}
+	SizeClass* cls = nullptr;
+	for (SizeClass& c : classes_) {
+		if (c.words == words) { cls = &c; break; }
+	}
+	if (!cls) cls = &classes_.emplace_back(SizeClass{words, {}});
+	cls->free.push_back(std::move(buffer));
+	stats_.pooledBytes += bytes;
+	++stats_.released;
+}
+
+void* StoragePool::allocateBlock(std::size_t bytes) {
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		for (BlockClass& c : blocks_) {
+			if (c.bytes != bytes || c.free.empty()) continue;
+			void* block = c.free.back();
+			c.free.pop_back();
+			stats_.pooledBytes -= bytes;
+			++stats_.hits;
+			return block;
+		}
+		++stats_.misses;
+	}
+	return ::operator new(bytes);
+}
+
+void StoragePool::freeBlock(void* block, std::size_t bytes) {
+	if (!block) return;
+	std::unique_lock<std::mutex> lock(mutex_);
+	if (stats_.pooledBytes + bytes > retainLimit_) {
+		++stats_.dropped;
+		lock.unlock();
+		::operator delete(block);
+		return;
+	}
+	BlockClass* cls = nullptr;
+	for (BlockClass& c : blocks_) {
+		if (c.bytes == bytes) { cls = &c; break; }
+	}
+	if (!cls) cls = &blocks_.emplace_back(BlockClass{bytes, {}});
+	cls->free.push_back(block);
+	stats_.pooledBytes += bytes;
+	++stats_.released;
+}
+
+void StoragePool::setRetainLimit(std::size_t bytes) {
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		retainLimit_ = bytes;
+		if (stats_.pooledBytes <= retainLimit_) return;
+	}
+	trim();
+}
+
+void StoragePool::trim() {
+	std::lock_guard<std::mutex> lock(mutex_);
+	classes_.clear();
+	for (BlockClass& c : blocks_) {
+		for (void* block : c.free) ::operator delete(block);
+	}
+	blocks_.clear();
+	stats_.pooledBytes = 0;
+}
+
+StoragePoolStats StoragePool::stats() const {
+	std::lock_guard<std::mutex> lock(mutex_);
+	return stats_;
+}
+
+} // namespace voxel
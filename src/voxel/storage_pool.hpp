@@ -0,0 +1,88 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+namespace voxel {
+
+struct StoragePoolStats {
+	std::uint64_t hits {0};     // acquires served from a recycled buffer or block
+	std::uint64_t misses {0};   // acquires that had to allocate
+	std::uint64_t released {0}; // buffers and blocks returned and kept
+	std::uint64_t dropped {0};  // returned past the retain limit and freed
+	std::size_t pooledBytes {0};
+};
+
+// Recycles the fixed-size index buffers behind PaletteStorage. A chunk's
+// buffer size only depends on its volume and bit width, so streaming
+// sections in and out keeps asking for the same handful of sizes; freed
+// buffers are parked per size and handed back out zeroed, without going
+// through the allocator. Chunk bodies themselves (and their shared_ptr
+// control blocks) come from recycled raw blocks; see PoolAllocator.
+class StoragePool {
+public:
+	StoragePool() = default;
+	~StoragePool() { trim(); }
+	StoragePool(const StoragePool&) = delete;
+	StoragePool& operator=(const StoragePool&) = delete;
+
+	// Zeroed buffer of exactly `words` words
+	std::vector<std::uint64_t> acquire(std::size_t words);
+	// A pooled buffer holding a copy of src (empty for an empty src)
+	std::vector<std::uint64_t> acquireCopy(const std::vector<std::uint64_t>& src);
+	// Return a buffer; it is kept for reuse unless the retain limit is hit
+	void release(std::vector<std::uint64_t>&& buffer);
+
+	// Uninitialized memory of `bytes` bytes, aligned for any scalar type;
+	// blocks are recycled by size like the buffers
+	void* allocateBlock(std::size_t bytes);
+	void freeBlock(void* block, std::size_t bytes);
+
+	// Upper bound on bytes parked in the pool; excess buffers are freed
+	void setRetainLimit(std::size_t bytes);
+	// Free every parked buffer
+	void trim();
+
+	StoragePoolStats stats() const;
+
+private:
+	struct SizeClass {
+		std::size_t words;
+		std::vector<std::vector<std::uint64_t>> free;
+	};
+	struct BlockClass {
+		std::size_t bytes;
+		std::vector<void*> free;
+	};
+
+	mutable std::mutex mutex_;
+	std::vector<SizeClass> classes_;
+	std::vector<BlockClass> blocks_;
+	std::size_t retainLimit_ { std::size_t{64} << 20 };
+	StoragePoolStats stats_{};
+};
+
+// Process-wide pool shared by all chunks
+StoragePool& storagePool();
+
+// Allocator over storagePool()'s blocks, for std::allocate_shared and
+// containers that are created and dropped with chunks
+template<class T>
+struct PoolAllocator {
+	using value_type = T;
+	static_assert(alignof(T) <= __STDCPP_DEFAULT_NEW_ALIGNMENT__, "blocks only have new's default alignment");
+
+	PoolAllocator() noexcept = default;
+	template<class U>
+	PoolAllocator(const PoolAllocator<U>&) noexcept {}
+
+	T* allocate(std::size_t n) { return static_cast<T*>(storagePool().allocateBlock(n * sizeof(T))); }
+	void deallocate(T* p, std::size_t n) noexcept { storagePool().freeBlock(p, n * sizeof(T)); }
+
+	template<class U>
+	bool operator==(const PoolAllocator<U>&) const noexcept { return true; }
+};
+
+} // namespace voxel
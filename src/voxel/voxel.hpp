@@ -4,6 +4,8 @@
 
 namespace voxel {
 
+// Block id. Only the built-in ids are named here; the rest are defined at
+// startup by the block registry (see block_registry.hpp).
 enum class BlockType : std::uint8_t {
 	Air = 0,
 	Dirt = 1
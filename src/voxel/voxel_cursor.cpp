@@ -0,0 +1,52 @@
+#include "voxel_cursor.hpp"
+#include "../config/config.hpp"
+
+namespace voxel {
+
+static int floorDiv(int a, int b) {
+	int q = a / b;
+	if ((a % b != 0) && ((a < 0) != (b < 0))) --q;
+	return q;
+}
+
+VoxelCursor::VoxelCursor(World& world, int x, int y, int z) : world_(world) {
+	const auto& dims = config::Config::instance().chunk();
+	size_[0] = dims.sizeX;
+	size_[1] = dims.sizeY;
+	size_[2] = dims.sizeZ;
+	moveTo(x, y, z);
+}
+
+void VoxelCursor::moveTo(int x, int y, int z) {
+	const int p[3] = { x, y, z };
+	for (int a = 0; a < 3; ++a) {
+		pos_[a] = p[a];
+		section_[a] = floorDiv(p[a], size_[a]);
+		local_[a] = p[a] - section_[a] * size_[a];
+	}
+	center_ = world_.findChunk(section_[0], section_[1], section_[2]);
+	known_ = 0;
+}
+
+Chunk* VoxelCursor::lookupNeighbour(int axis, int dir) {
+	int s[3] = { section_[0], section_[1], section_[2] };
+	s[axis] += dir;
+	const int f = face(axis, dir);
+	near_[f] = world_.findChunk(s[0], s[1], s[2]);
+	known_ |= static_cast<std::uint8_t>(1u << f);
+	return near_[f];
+}
+
+void VoxelCursor::crossBorder(int axis, int dir) {
+	Chunk* next = neighbour(axis, dir);
+	Chunk* prev = center_;
+	section_[axis] += dir;
+	local_[axis] = dir > 0 ? 0 : size_[axis] - 1;
+	center_ = next;
+	// Only the section just left is known to be adjacent to the new one
+	const int back = face(axis, -dir);
+	near_[back] = prev;
+	known_ = static_cast<std::uint8_t>(1u << back);
+}
+
+} // namespace voxel
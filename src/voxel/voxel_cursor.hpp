@@ -0,0 +1,79 @@
+#pragma once
+
+#include <cstdint>
+#include "world.hpp"
+
+namespace voxel {
+
+// World-space voxel position that remembers which section it is in.
+// Stepping +-1 along an axis stays inside the cached section until it
+// crosses a border; only then is the neighbouring section looked up, and
+// the six face neighbours are cached as they are first peeked at.
+// Section pointers stay valid while sections are created, but a cursor
+// must be re-seated with moveTo after sections are evicted.
+class VoxelCursor {
+public:
+	VoxelCursor(World& world, int x, int y, int z);
+
+	void moveTo(int x, int y, int z);
+	// One voxel along axis (0=X, 1=Y, 2=Z); dir is +1 or -1
+	void step(int axis, int dir) {
+		pos_[axis] += dir;
+		const int l = local_[axis] + dir;
+		if (l >= 0 && l < size_[axis]) {
+			local_[axis] = l;
+			return;
+		}
+		crossBorder(axis, dir);
+	}
+
+	int x() const { return pos_[0]; }
+	int y() const { return pos_[1]; }
+	int z() const { return pos_[2]; }
+	// False when the current section is not resident; reads give air
+	bool resident() const { return center_ != nullptr; }
+
+	BlockType get() const {
+		return center_ ? center_->get(local_[0], local_[1], local_[2]) : BlockType::Air;
+	}
+	// False when the section is not resident
+	bool set(BlockType t) {
+		if (!center_) return false;
+		center_->set(local_[0], local_[1], local_[2], t);
+		return true;
+	}
+
+	// The voxel one step along axis/dir, without moving
+	BlockType peek(int axis, int dir) {
+		int l[3] = { local_[0], local_[1], local_[2] };
+		l[axis] += dir;
+		const Chunk* c = center_;
+		if (l[axis] < 0 || l[axis] >= size_[axis]) {
+			l[axis] = dir > 0 ? 0 : size_[axis] - 1;
+			c = neighbour(axis, dir);
+		}
+		return c ? c->get(l[0], l[1], l[2]) : BlockType::Air;
+	}
+
+private:
+	World& world_;
+	int size_[3];
+	int pos_[3] {};
+	int local_[3] {};
+	int section_[3] {};
+	Chunk* center_ {nullptr};
+	// Face neighbours indexed axis * 2 + (dir > 0); valid where known_ has the bit
+	Chunk* near_[6] {};
+	std::uint8_t known_ {0};
+
+	static int face(int axis, int dir) { return axis * 2 + (dir > 0 ? 1 : 0); }
+	Chunk* neighbour(int axis, int dir) {
+		const int f = face(axis, dir);
+		if (known_ & (1u << f)) return near_[f];
+		return lookupNeighbour(axis, dir);
+	}
+	Chunk* lookupNeighbour(int axis, int dir);
+	void crossBorder(int axis, int dir);
+};
+
+} // namespace voxel
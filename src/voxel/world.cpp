@@ -1,22 +1,97 @@
 #include "world.hpp"
+#include "chunk_codec.hpp"
 #include "../config/config.hpp"
+#include "../core/logging.hpp"
+#include <cassert>
+#include <string>
 
 namespace voxel {
 
-Chunk& World::getOrCreateChunk(int cx, int cz) {
-	auto key = std::make_pair(cx, cz);
-	auto it = chunks_.find(key);
-	if (it == chunks_.end()) {
-		const auto& dims = config::Config::instance().chunk();
-		it = chunks_.emplace(key, Chunk{dims.sizeX, dims.sizeY, dims.sizeZ}).first;
+Chunk& World::getOrCreateChunk(int cx, int cy, int cz) {
+	assert(chunkKeyInRange(cx, cy, cz));
+	if (Chunk* c = findChunk(cx, cy, cz)) return *c;
+	const auto& dims = config::Config::instance().chunk();
+	return chunks_.insert(packChunkKey(cx, cy, cz), Chunk{dims.sizeX, dims.sizeY, dims.sizeZ, BlockType::Air, parseChunkLayout(dims.layout)});
+}
+
+bool World::hasChunk(int cx, int cy, int cz) const {
+	return findChunk(cx, cy, cz) != nullptr || isCold(cx, cy, cz);
+}
+
+bool World::eraseChunk(int cx, int cy, int cz) {
+	if (!chunkKeyInRange(cx, cy, cz)) return false;
+	const std::uint64_t key = packChunkKey(cx, cy, cz);
+	auto it = cold_.find(key);
+	if (it != cold_.end()) {
+		coldBytes_ -= it->second.bytes.capacity();
+		cold_.erase(it);
+		return true;
 	}
-	return it->second;
+	return chunks_.erase(key);
 }
 
-bool World::hasChunk(int cx, int cz) const {
-	return chunks_.find(std::make_pair(cx, cz)) != chunks_.end();
+bool World::freezeChunk(int cx, int cy, int cz) {
+	if (!chunkKeyInRange(cx, cy, cz)) return false;
+	const std::uint64_t key = packChunkKey(cx, cy, cz);
+	Chunk* c = chunks_.find(key);
+	if (!c || c->editMask() != 0 || c->memoryUsage() == 0) return false;
+	ColdChunk cold;
+	encodeChunkRle(*c, cold.bytes);
+	cold.bytes.shrink_to_fit();
+	cold.version = c->version();
+	cold.dirty = c->isDirty();
+	chunks_.erase(key);
+	coldBytes_ += cold.bytes.capacity();
+	cold_.emplace(key, std::move(cold));
+	return true;
 }
 
-} // namespace voxel
+Chunk* World::thaw(std::uint64_t key) {
+	auto it = cold_.find(key);
+	if (it == cold_.end()) return nullptr;
+	const auto& dims = config::Config::instance().chunk();
+	Chunk chunk{dims.sizeX, dims.sizeY, dims.sizeZ, BlockType::Air, parseChunkLayout(dims.layout)};
+	if (!decodeChunkRle(it->second.bytes.data(), it->second.bytes.size(), chunk)) {
+		// Dropped rather than replaced by air, so the section reads as not
+		// resident and is loaded again from its last save
+		const std::string where = std::to_string(chunkKeyX(key)) + "," + std::to_string(chunkKeyY(key)) + "," + std::to_string(chunkKeyZ(key));
+		if (it->second.dirty) {
+			++lostDirty_;
+			core::log(core::LogLevel::Error, "Cold section (" + where + ") failed to decode; its unsaved edits are lost");
+		} else {
+			core::log(core::LogLevel::Warn, "Cold section (" + where + ") failed to decode; dropped");
+		}
+		coldBytes_ -= it->second.bytes.capacity();
+		cold_.erase(it);
+		return nullptr;
+	}
+	chunk.resumeVersion(it->second.version);
+	if (!it->second.dirty) chunk.clearDirty();
+	// Coming back is not an edit; the content is what was last meshed
+	chunk.takeEditMask();
+	coldBytes_ -= it->second.bytes.capacity();
+	cold_.erase(it);
+	return &chunks_.insert(key, std::move(chunk));
+}
 
+bool World::isColdDirty(int cx, int cy, int cz) const {
+	if (!chunkKeyInRange(cx, cy, cz)) return false;
+	auto it = cold_.find(packChunkKey(cx, cy, cz));
+	return it != cold_.end() && it->second.dirty;
+}
+
+std::vector<SectionCoord> World::coldDirtySections() const {
+	std::vector<SectionCoord> out;
+	for (const auto& [key, cold] : cold_) {
+		if (cold.dirty) out.push_back(SectionCoord{ chunkKeyX(key), chunkKeyY(key), chunkKeyZ(key) });
+	}
+	return out;
+}
 
+std::size_t World::memoryUsage() const {
+	std::size_t bytes = coldBytes_;
+	chunks_.forEach([&](std::uint64_t, const Chunk& chunk) { bytes += chunk.memoryUsage(); });
+	return bytes;
+}
+
+} // namespace voxel
@@ -1,27 +1,97 @@
 #pragma once
 
-#include <unordered_map>
-#include <utility>
 #include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
 #include "chunk.hpp"
+#include "chunk_map.hpp"
 
 namespace voxel {
 
-struct ChunkCoordHash {
-	std::size_t operator()(const std::pair<int,int>& v) const noexcept {
-		return (static_cast<size_t>(v.first) << 32) ^ static_cast<size_t>(v.second);
-	}
+struct SectionCoord {
+	int cx, cy, cz;
+	friend bool operator==(const SectionCoord&, const SectionCoord&) = default;
+	friend auto operator<=>(const SectionCoord&, const SectionCoord&) = default;
 };
 
+// Sparse set of cubic chunk sections keyed by (cx, cy, cz). Worlds grow
+// vertically by adding sections, not by making every chunk taller.
+// Resident sections are either hot (a live Chunk) or cold: run-length
+// encoded in memory (see chunk_codec.hpp) and decoded again the first
+// time they are looked up. Freezing destroys the Chunk, so pointers to it
+// go stale exactly as on eviction.
+//
+// Section coordinates must lie within packChunkKey's range: lookups,
+// erase and freeze treat others as not resident, and getOrCreateChunk
+// requires them (see chunkKeyInRange).
 class World {
 public:
-	Chunk& getOrCreateChunk(int cx, int cz);
-	bool hasChunk(int cx, int cz) const;
+	Chunk& getOrCreateChunk(int cx, int cy, int cz);
+	// Hot or cold
+	bool hasChunk(int cx, int cy, int cz) const;
+	// Drop a section and its voxel storage; false if it was not resident
+	bool eraseChunk(int cx, int cy, int cz);
+
+	// One hash probe for hot sections; a cold section is thawed first.
+	// nullptr when the section is not resident, or was cold and failed to
+	// decode: it is then dropped (see lostDirtySections).
+	Chunk* findChunk(int cx, int cy, int cz) {
+		if (!chunkKeyInRange(cx, cy, cz)) return nullptr;
+		const std::uint64_t key = packChunkKey(cx, cy, cz);
+		if (Chunk* c = chunks_.find(key)) return c;
+		return cold_.empty() ? nullptr : thaw(key);
+	}
+	// Hot sections only; a const World cannot thaw
+	const Chunk* findChunk(int cx, int cy, int cz) const {
+		return chunkKeyInRange(cx, cy, cz) ? chunks_.find(packChunkKey(cx, cy, cz)) : nullptr;
+	}
+
+	// Encode a hot section into the cold tier. Refused (false) for sections
+	// that are not hot, have edits not yet taken for remeshing, or hold no
+	// voxel buffers to shrink.
+	bool freezeChunk(int cx, int cy, int cz);
+	bool isCold(int cx, int cy, int cz) const {
+		return chunkKeyInRange(cx, cy, cz) && cold_.count(packChunkKey(cx, cy, cz)) != 0;
+	}
+	// True when the section is cold and was edited since it was last saved
+	bool isColdDirty(int cx, int cy, int cz) const;
+
+	// Visit every hot section as f(cx, cy, cz, chunk)
+	template<class F>
+	void forEachChunk(F&& f) {
+		chunks_.forEach([&](std::uint64_t key, Chunk& c) { f(chunkKeyX(key), chunkKeyY(key), chunkKeyZ(key), c); });
+	}
+	template<class F>
+	void forEachChunk(F&& f) const {
+		chunks_.forEach([&](std::uint64_t key, const Chunk& c) { f(chunkKeyX(key), chunkKeyY(key), chunkKeyZ(key), c); });
+	}
+	// Cold sections edited since they were last saved
+	std::vector<SectionCoord> coldDirtySections() const;
+	// Cold sections with unsaved edits dropped because they failed to decode
+	std::size_t lostDirtySections() const { return lostDirty_; }
+
+	// Hot and cold sections
+	std::size_t chunkCount() const { return chunks_.size() + cold_.size(); }
+	std::size_t coldCount() const { return cold_.size(); }
+	std::size_t coldBytes() const { return coldBytes_; }
+	// Bytes of voxel storage across all resident chunks, cold ones at
+	// their encoded size
+	std::size_t memoryUsage() const;
 
 private:
-	std::unordered_map<std::pair<int,int>, Chunk, ChunkCoordHash> chunks_;
-};
+	struct ColdChunk {
+		std::vector<std::uint8_t> bytes;
+		std::uint64_t version {0};
+		bool dirty {false};
+	};
 
-} // namespace voxel
+	ChunkMap chunks_;
+	std::unordered_map<std::uint64_t, ColdChunk> cold_;
+	std::size_t coldBytes_ {0};
+	std::size_t lostDirty_ {0};
 
+	Chunk* thaw(std::uint64_t key);
+};
 
+} // namespace voxel
@@ -1,13 +1,41 @@
 #include "world_manager.hpp"
 #include "../config/config.hpp"
+#include "../core/debug_counters.hpp"
+#include "storage_pool.hpp"
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstdlib>
+#include <filesystem>
 
 namespace voxel {
 
+// Region files kept open at once before the handle cache is dropped
+static constexpr std::size_t kMaxOpenRegions = 64;
+// Loads completed on the I/O service that one updatePlayerPosition installs
+static constexpr std::size_t kIoResumesPerUpdate = 64;
+
 WorldManager::WorldManager(World& world) : world_(world) {
 	const auto& dims = config::Config::instance().chunk();
 	chunkSizeX_ = dims.sizeX;
 	chunkSizeY_ = dims.sizeY;
 	chunkSizeZ_ = dims.sizeZ;
+	pow2_ = std::has_single_bit(static_cast<unsigned>(chunkSizeX_))
+		&& std::has_single_bit(static_cast<unsigned>(chunkSizeY_))
+		&& std::has_single_bit(static_cast<unsigned>(chunkSizeZ_));
+	shiftX_ = std::countr_zero(static_cast<unsigned>(chunkSizeX_));
+	shiftY_ = std::countr_zero(static_cast<unsigned>(chunkSizeY_));
+	shiftZ_ = std::countr_zero(static_cast<unsigned>(chunkSizeZ_));
+	const auto& wc = config::Config::instance().world();
+	minSectionY_ = wc.min_section_y;
+	maxSectionY_ = std::max(wc.min_section_y, wc.max_section_y);
+	verticalViewDistance_ = wc.vertical_view_distance;
+	unloadHysteresis_ = std::max(0, wc.unload_hysteresis);
+	memoryBudget_ = static_cast<std::size_t>(std::max(0, wc.memory_budget_mb)) << 20;
+	coldAfterMoves_ = std::max(0, wc.cold_after_moves);
+	journalSyncInterval_ = std::chrono::milliseconds(std::max(0, wc.journal_sync_ms));
+	journalCheckpointBytes_ = static_cast<std::size_t>(std::max(1, wc.journal_checkpoint_kb)) << 10;
+	storagePool().setRetainLimit(static_cast<std::size_t>(std::max(0, wc.storage_pool_mb)) << 20);
 }
 
 void WorldManager::setViewDistance(int chunksRadius) { viewDistance_ = chunksRadius; }
@@ -25,43 +53,585 @@ int WorldManager::mod(int a, int b) {
 	return m;
 }
 
-void WorldManager::ensureChunksAround(int cx, int cz) {
+std::string WorldManager::regionPath(int cx, int cy, int cz) const {
+	return regionFilePath(saveDir_, cx, cy, cz);
+}
+
+RegionFile* WorldManager::region(int cx, int cy, int cz, bool create) {
+	if (saveDir_.empty()) return nullptr;
+	const std::uint64_t key = packChunkKey(regionCoord(cx), cy, regionCoord(cz));
+	auto it = regions_.find(key);
+	if (it != regions_.end() && (it->second || !create)) return it->second.get();
+	auto file = std::make_unique<RegionFile>();
+	if (!file->open(regionPath(cx, cy, cz), create)) file.reset();
+	// Bound open handles. A region is closed once what it has staged is
+	// flushed; one that fails stays open so the writes are not lost.
+	if (it == regions_.end() && regions_.size() >= kMaxOpenRegions) {
+		for (auto r = regions_.begin(); r != regions_.end();) {
+			if (!r->second || r->second->flush()) r = regions_.erase(r);
+			else ++r;
+		}
+	}
+	return (regions_[key] = std::move(file)).get();
+}
+
+bool WorldManager::flushRegions() {
+	bool ok = true;
+	for (auto& kv : regions_) {
+		if (kv.second && kv.second->hasPending()) ok = kv.second->flush() && ok;
+	}
+	return ok;
+}
+
+void WorldManager::touch(std::uint64_t key) {
+	auto it = lruPos_.find(key);
+	if (it != lruPos_.end()) {
+		lru_.splice(lru_.begin(), lru_, it->second.pos);
+		it->second.lastInView = moves_;
+		return;
+	}
+	lru_.push_front(key);
+	lruPos_.emplace(key, LruEntry{ lru_.begin(), moves_ });
+}
+
+void WorldManager::streamIn(int cx, int cy, int cz, bool wait) {
+	// Beyond the key range there is no section to stream (see packChunkKey)
+	if (!chunkKeyInRange(cx, cy, cz)) return;
+	const std::uint64_t key = packChunkKey(cx, cy, cz);
+	touch(key);
+	if (world_.hasChunk(cx, cy, cz)) {
+		if (!wait) return;
+		// Callers that wait read the section next, so a cold one is thawed
+		// here; one that fails to decode is dropped and read back below
+		if (world_.findChunk(cx, cy, cz)) {
+			settleLoad(cx, cy, cz);
+			return;
+		}
+	}
+	Chunk& c = world_.getOrCreateChunk(cx, cy, cz);
+	// New sections start as uniform air and cost no voxel storage; only
+	// sections that were saved with blocks in them are read back
+	if (io_) {
+		const std::uint64_t ticket = ++nextLoadTicket_;
+		loading_[key] = ticket;
+		if (wait) installLoaded(cx, cy, cz, ticket, io_->loadNow(cx, cy, cz));
+		else loadSection(cx, cy, cz, ticket);
+		return;
+	}
+	RegionFile* r = region(cx, cy, cz, false);
+	if (r && r->read(regionLocal(cx), regionLocal(cz), ioBuffer_)) c.loadFromBuffer(ioBuffer_.data(), ioBuffer_.size());
+}
+
+IoTask WorldManager::loadSection(int cx, int cy, int cz, std::uint64_t ticket) {
+	std::optional<Chunk> loaded = co_await io_->load(cx, cy, cz);
+	installLoaded(cx, cy, cz, ticket, std::move(loaded));
+}
+
+void WorldManager::settleLoad(int cx, int cy, int cz) {
+	if (loading_.empty()) return;
+	// Still a placeholder waiting on its load: fetch it now instead
+	auto it = loading_.find(packChunkKey(cx, cy, cz));
+	if (it != loading_.end()) installLoaded(cx, cy, cz, it->second, io_->loadNow(cx, cy, cz));
+}
+
+void WorldManager::installLoaded(int cx, int cy, int cz, std::uint64_t ticket, std::optional<Chunk> loaded) {
+	auto it = loading_.find(packChunkKey(cx, cy, cz));
+	if (it == loading_.end() || it->second != ticket) return;
+	loading_.erase(it);
+	if (!loaded) return;
+	Chunk* c = world_.findChunk(cx, cy, cz);
+	if (!c) return;
+	// Edits through this manager settle the load first (settleLoad), but
+	// direct World or cursor writes can reach the air placeholder. Carry
+	// what they placed over onto the loaded section; the versions go on
+	// from the placeholder's, so a save of it in flight cannot clear the
+	// merged edits' dirty flag.
+	if (c->version() != 0) mergePlaceholder(*c, *loaded);
+	*c = std::move(*loaded);
+	c->markRemesh();
+	edits_.push(cx, cy, cz);
+}
+
+void WorldManager::mergePlaceholder(const Chunk& placeholder, Chunk& loaded) {
+	loaded.resumeVersion(placeholder.version());
+	const int sx = loaded.sizeX(), sy = loaded.sizeY(), sz = loaded.sizeZ();
+	auto inside = [&](int x, int y, int z) { return x < sx && y < sy && z < sz; };
+	if (!(placeholder.isUniform() && placeholder.uniformType() == BlockType::Air)) {
+		placeholder.forEachVoxel([&](int x, int y, int z, BlockType t) {
+			if (t != BlockType::Air && inside(x, y, z)) loaded.set(x, y, z, t);
+		});
+	}
+	for (std::size_t i = 0; i < kVoxelChannelCount; ++i) {
+		const VoxelChannel ch = static_cast<VoxelChannel>(i);
+		if (!placeholder.hasChannel(ch)) continue;
+		for (int y = 0; y < placeholder.sizeY(); ++y)
+			for (int z = 0; z < placeholder.sizeZ(); ++z)
+				for (int x = 0; x < placeholder.sizeX(); ++x) {
+					const std::uint8_t v = placeholder.channel(ch, x, y, z);
+					if (v != 0 && inside(x, y, z)) loaded.setChannel(ch, x, y, z, v);
+				}
+	}
+}
+
+bool WorldManager::inView(std::uint64_t key, int margin) const {
+	return std::abs(chunkKeyX(key) - playerChunkX_) <= viewDistance_ + margin
+		&& std::abs(chunkKeyZ(key) - playerChunkZ_) <= viewDistance_ + margin
+		&& std::abs(chunkKeyY(key) - playerChunkY_) <= verticalViewDistance_ + margin;
+}
+
+bool WorldManager::saveSection(int cx, int cy, int cz, Chunk& c) {
+	if (journal_) {
+		// Write-ahead: the edits in this save must be replayable first
+		journal_->sync();
+		checkpointRegions_.insert(packChunkKey(regionCoord(cx), cy, regionCoord(cz)));
+	}
+	if (io_) {
+		// Stays dirty until the write completes (see saveBehind)
+		saveBehind(cx, cy, cz, c.version(), c.snapshot());
+		return !(c.isUniform() && c.uniformType() == BlockType::Air);
+	}
+	if (saveDir_.empty()) return false;
+	if (c.isUniform() && c.uniformType() == BlockType::Air) {
+		// Nothing to keep; drop any stale payload from when it held blocks
+		if (RegionFile* r = region(cx, cy, cz, false)) r->erase(regionLocal(cx), regionLocal(cz));
+		c.clearDirty();
+		return false;
+	}
+	// On failure the section stays dirty, so the next save tries again
+	RegionFile* r = region(cx, cy, cz, true);
+	if (!r) return false;
+	c.saveToBuffer(ioBuffer_);
+	r->write(regionLocal(cx), regionLocal(cz), ioBuffer_.data(), ioBuffer_.size());
+	c.clearDirty();
+	return true;
+}
+
+IoTask WorldManager::saveBehind(int cx, int cy, int cz, std::uint64_t version, std::shared_ptr<const Chunk> snapshot) {
+	const bool ok = co_await io_->save(cx, cy, cz, std::move(snapshot));
+	// Only a hot section still at the saved version is clean; an edit since
+	// leaves it dirty for the next save. findChunk would thaw a cold one.
+	if (!ok || world_.isCold(cx, cy, cz)) co_return;
+	Chunk* c = world_.findChunk(cx, cy, cz);
+	if (c && c->version() == version) c->clearDirty();
+}
+
+std::size_t WorldManager::evict(std::uint64_t key) {
+	auto pos = lruPos_.find(key);
+	const int cx = chunkKeyX(key), cy = chunkKeyY(key), cz = chunkKeyZ(key);
+	if (world_.isCold(cx, cy, cz) && !world_.isColdDirty(cx, cy, cz)) {
+		// Nothing to save, so no need to decode it first
+		dropFromLru(key);
+		const std::size_t before = world_.coldBytes();
+		world_.eraseChunk(cx, cy, cz);
+		++evicted_;
+		return before - world_.coldBytes();
+	}
+	// A cold section with unsaved edits is thawed to be saved
+	const bool wasCold = world_.isCold(cx, cy, cz);
+	const std::size_t coldBefore = world_.coldBytes();
+	Chunk* c = world_.findChunk(cx, cy, cz);
+	if (!c) {
+		// A cold section that failed to decode was dropped by the thaw
+		dropFromLru(key);
+		return wasCold ? coldBefore - world_.coldBytes() : 0;
+	}
+	// Without a save directory edits to evicted sections are lost. With
+	// one, a section whose save could not be staged stays resident (and
+	// dirty) and moves to the LRU front, to be retried later.
+	if (c->isDirty() && saveSection(cx, cy, cz, *c)) ++core::debugCounters().savedOnEvict;
+	if (c->isDirty() && !io_ && !saveDir_.empty()) {
+		if (pos != lruPos_.end()) lru_.splice(lru_.begin(), lru_, pos->second.pos);
+		if (wasCold) world_.freezeChunk(cx, cy, cz);
+		return 0;
+	}
+	dropFromLru(key);
+	// What goes is what was counted: the encoding of a thawed section,
+	// not the decoded copy that only existed for the save
+	const std::size_t bytes = wasCold ? coldBefore - world_.coldBytes() : c->memoryUsage();
+	world_.eraseChunk(cx, cy, cz);
+	++evicted_;
+	return bytes;
+}
+
+void WorldManager::dropFromLru(std::uint64_t key) {
+	auto pos = lruPos_.find(key);
+	if (pos != lruPos_.end()) {
+		lru_.erase(pos->second.pos);
+		lruPos_.erase(pos);
+	}
+	loading_.erase(key);
+}
+
+void WorldManager::unloadOutside() {
+	std::size_t bytes = world_.memoryUsage();
+	// Radius: anything past the view distance plus hysteresis goes
+	for (auto it = lru_.begin(); it != lru_.end();) {
+		const std::uint64_t key = *it++;
+		if (!inView(key, unloadHysteresis_)) bytes -= evict(key);
+	}
+	// Compressing idle sections is cheaper than dropping them, so it
+	// comes before the budget
+	bytes -= freezeIdle();
+	// Budget: sections in view were just touched, so the LRU tail holds
+	// the hysteresis band, oldest first; stop once the tail is in view.
+	// Sections that could not be saved rotate to the front, so each one
+	// is tried at most once.
+	for (std::size_t tries = lru_.size(); tries != 0 && memoryBudget_ != 0 && bytes > memoryBudget_
+		&& !lru_.empty() && !inView(lru_.back(), 0); --tries) {
+		bytes -= evict(lru_.back());
+	}
+	flushRegions();
+	publishCounters(bytes);
+}
+
+std::size_t WorldManager::freezeIdle() {
+	if (coldAfterMoves_ == 0) return 0;
+	std::size_t saved = 0;
+	// Oldest first; stop at the first section seen in view recently enough
+	for (auto it = lru_.rbegin(); it != lru_.rend(); ++it) {
+		const LruEntry& e = lruPos_.find(*it)->second;
+		if (moves_ - e.lastInView < static_cast<std::uint64_t>(coldAfterMoves_)) break;
+		const int cx = chunkKeyX(*it), cy = chunkKeyY(*it), cz = chunkKeyZ(*it);
+		if (world_.isCold(cx, cy, cz)) continue;
+		const Chunk* c = world_.findChunk(cx, cy, cz);
+		if (!c) continue;
+		const std::size_t hot = c->memoryUsage();
+		const std::size_t coldBefore = world_.coldBytes();
+		if (world_.freezeChunk(cx, cy, cz)) saved += hot - (world_.coldBytes() - coldBefore);
+	}
+	return saved;
+}
+
+void WorldManager::publishCounters(std::size_t bytes) const {
+	core::DebugCounters& dc = core::debugCounters();
+	dc.residentChunks = world_.chunkCount();
+	dc.evictedChunks = evicted_;
+	dc.residentVoxelBytes = bytes;
+	dc.coldChunks = world_.coldCount();
+	dc.coldVoxelBytes = world_.coldBytes();
+	const StoragePoolStats ps = storagePool().stats();
+	dc.poolHits = ps.hits;
+	dc.poolMisses = ps.misses;
+}
+
+void WorldManager::ensureChunksAround(int cx, int cy, int cz) {
+	const int y0 = std::max(minSectionY_, cy - verticalViewDistance_);
+	const int y1 = std::min(maxSectionY_, cy + verticalViewDistance_);
 	for (int dz = -viewDistance_; dz <= viewDistance_; ++dz) {
 		for (int dx = -viewDistance_; dx <= viewDistance_; ++dx) {
-			world_.getOrCreateChunk(cx + dx, cz + dz);
+			for (int sy = y0; sy <= y1; ++sy) {
+				streamIn(cx + dx, sy, cz + dz);
+			}
 		}
 	}
-	// Optional: unload beyond radius - simple pass for now
+	unloadOutside();
+}
+
+WorldManager::~WorldManager() {
+	if (journal_) journal_->sync();
+	if (io_) io_->drain();
 }
 
-void WorldManager::updatePlayerPosition(float x, float, float z) {
-	int cx = floorDiv(static_cast<int>(x), chunkSizeX_);
-	int cz = floorDiv(static_cast<int>(z), chunkSizeZ_);
-	if (cx != playerChunkX_ || cz != playerChunkZ_) {
-		playerChunkX_ = cx; playerChunkZ_ = cz;
-		ensureChunksAround(cx, cz);
+void WorldManager::setIoService(ChunkIoService* io) {
+	if (io_ == io) return;
+	if (io_) io_->drain();
+	flushRegions();
+	regions_.clear();
+	io_ = io;
+}
+
+void WorldManager::updatePlayerPosition(float x, float y, float z) {
+	// Finished loads land first, a bounded number per call
+	if (io_) io_->poll(kIoResumesPerUpdate);
+	int cx = chunkX(static_cast<int>(std::floor(x)));
+	int cy = std::clamp(chunkY(static_cast<int>(std::floor(y))), minSectionY_, maxSectionY_);
+	int cz = chunkZ(static_cast<int>(std::floor(z)));
+	if (!streamed_ || cx != playerChunkX_ || cy != playerChunkY_ || cz != playerChunkZ_) {
+		playerChunkX_ = cx; playerChunkY_ = cy; playerChunkZ_ = cz;
+		streamed_ = true;
+		++moves_;
+		ensureChunksAround(cx, cy, cz);
 	}
+	syncJournal();
+}
+
+void WorldManager::syncJournal() {
+	if (!journal_) return;
+	journal_->syncIfDue(journalSyncInterval_);
+	if (journal_->size() >= journalCheckpointBytes_) checkpoint();
+}
+
+void WorldManager::setJournal(EditJournal* journal) {
+	if (journal_ && journal_ != journal) journal_->sync();
+	journal_ = journal;
 }
 
-Voxel* WorldManager::tryGetVoxel(int x, int y, int z) {
-	int cx = floorDiv(x, chunkSizeX_);
-	int cz = floorDiv(z, chunkSizeZ_);
-	if (!world_.hasChunk(cx, cz)) return nullptr;
-	int lx = mod(x, chunkSizeX_);
-	int ly = y;
-	int lz = mod(z, chunkSizeZ_);
-	if (ly < 0 || ly >= chunkSizeY_) return nullptr;
-	Chunk& c = world_.getOrCreateChunk(cx, cz);
-	return &c.at(lx, ly, lz);
+int WorldManager::replayJournal() {
+	if (!journal_) return 0;
+	const std::vector<JournalRun> runs = journal_->replay();
+	// The runs are in the journal already; applying them must not add more
+	EditJournal* journal = journal_;
+	journal_ = nullptr;
+	for (const JournalRun& r : runs) {
+		fillBox(r.x, r.y, r.z, r.x + static_cast<int>(r.length) - 1, r.y, r.z, r.newType);
+	}
+	journal_ = journal;
+	return static_cast<int>(runs.size());
+}
+
+int WorldManager::checkpoint() {
+	if (!journal_) return saveSections();
+	const std::string& dir = io_ ? io_->saveDirectory() : saveDir_;
+	if (dir.empty() || !journal_->sync()) return -1;
+	const int written = saveSections();
+	bool ok = written >= 0;
+	if (io_) ok = io_->drain() && ok;
+	for (std::uint64_t key : checkpointRegions_) {
+		const std::string path = regionFilePath(dir, chunkKeyX(key) * kRegionChunks, chunkKeyY(key), chunkKeyZ(key) * kRegionChunks);
+		std::error_code ec;
+		// Regions that only had all-air sections dropped may not exist
+		if (std::filesystem::exists(path, ec)) ok = syncFile(path) && ok;
+	}
+	if (!checkpointRegions_.empty()) ok = syncFile(dir) && ok;
+	// Keep the journal (and the regions to sync) until a checkpoint succeeds
+	if (!ok) return -1;
+	checkpointRegions_.clear();
+	return journal_->reset() ? written : -1;
+}
+
+void WorldManager::setSaveDirectory(const std::string& dir) {
+	regions_.clear();
+	saveDir_ = dir;
+	std::error_code ec;
+	if (!saveDir_.empty()) std::filesystem::create_directories(saveDir_, ec);
+}
+
+int WorldManager::saveSections() {
+	int written = 0;
+	bool failed = false;
+	// Cold sections are thawed to be written; the cold policy refreezes them
+	for (const SectionCoord& sc : world_.coldDirtySections()) world_.findChunk(sc.cx, sc.cy, sc.cz);
+	// Unsaved edits dropped with an undecodable cold section since the
+	// last save fail it, so a checkpoint keeps the journal holding them
+	if (world_.lostDirtySections() != lostDirtySeen_) {
+		lostDirtySeen_ = world_.lostDirtySections();
+		failed = true;
+	}
+	world_.forEachChunk([&](int cx, int cy, int cz, Chunk& c) {
+		if (!c.isDirty()) return;
+		if (saveSection(cx, cy, cz, c)) ++written;
+		// A synchronous save that was staged cleared the flag
+		else if (!io_ && !saveDir_.empty() && c.isDirty()) failed = true;
+	});
+	if (!flushRegions()) failed = true;
+	return failed ? -1 : written;
+}
+
+bool WorldManager::tryGetVoxel(int x, int y, int z, Voxel& out) {
+	const Chunk* c = world_.findChunk(chunkX(x), chunkY(y), chunkZ(z));
+	if (!c) return false;
+	out = c->at(localX(x), localY(y), localZ(z));
+	return true;
 }
 
 bool WorldManager::setVoxel(int x, int y, int z, const Voxel& v) {
-	Voxel* p = tryGetVoxel(x, y, z);
-	if (!p) return false;
-	*p = v;
+	if (!chunkKeyInRange(chunkX(x), chunkY(y), chunkZ(z))) return false;
+	settleLoad(chunkX(x), chunkY(y), chunkZ(z));
+	Chunk* c = world_.findChunk(chunkX(x), chunkY(y), chunkZ(z));
+	if (!c) return false;
+	if (journal_) {
+		const BlockType old = c->get(localX(x), localY(y), localZ(z));
+		if (old != v.type) journal_->append(JournalRun{ x, y, z, 1, old, v.type });
+	}
+	c->set(localX(x), localY(y), localZ(z), v.type);
+	edits_.push(chunkX(x), chunkY(y), chunkZ(z));
 	return true;
 }
 
-} // namespace voxel
+void WorldManager::captureBox(const Chunk& c, int lx0, int ly0, int lz0, int lx1, int ly1, int lz1) {
+	journalBeforeUniform_ = c.isUniform();
+	journalBeforeType_ = c.uniformType();
+	if (journalBeforeUniform_) return;
+	journalBefore_.clear();
+	for (int ly = ly0; ly < ly1; ++ly)
+		for (int lz = lz0; lz < lz1; ++lz)
+			for (int lx = lx0; lx < lx1; ++lx) journalBefore_.push_back(c.get(lx, ly, lz));
+}
 
+void WorldManager::journalBox(const Chunk& c, int cx, int cy, int cz, int lx0, int ly0, int lz0, int lx1, int ly1, int lz1) {
+	const int ox = cx * chunkSizeX_, oy = cy * chunkSizeY_, oz = cz * chunkSizeZ_;
+	std::size_t i = 0;
+	for (int ly = ly0; ly < ly1; ++ly) {
+		for (int lz = lz0; lz < lz1; ++lz) {
+			// One run per stretch of the row with the same old and new type
+			JournalRun run;
+			for (int lx = lx0; lx < lx1; ++lx, ++i) {
+				const BlockType before = journalBeforeUniform_ ? journalBeforeType_ : journalBefore_[i];
+				const BlockType after = c.get(lx, ly, lz);
+				if (run.length != 0 && before == run.oldType && after == run.newType) {
+					++run.length;
+					continue;
+				}
+				if (run.length != 0) journal_->append(run);
+				run = JournalRun{ ox + lx, oy + ly, oz + lz, before != after ? 1u : 0u, before, after };
+			}
+			if (run.length != 0) journal_->append(run);
+		}
+	}
+}
 
+template<class F>
+int WorldManager::forEachSectionInBox(int x0, int y0, int z0, int x1, int y1, int z1, F&& f) {
+	if (x0 > x1) std::swap(x0, x1);
+	if (y0 > y1) std::swap(y0, y1);
+	if (z0 > z1) std::swap(z0, z1);
+	// Sections outside the key range are not part of the world
+	const int cy0 = std::max({ minSectionY_, chunkY(y0), kChunkCoordMin });
+	const int cy1 = std::min({ maxSectionY_, chunkY(y1), kChunkCoordMax });
+	const int cz0 = std::max(chunkZ(z0), kChunkCoordMin), cz1 = std::min(chunkZ(z1), kChunkCoordMax);
+	const int cx0 = std::max(chunkX(x0), kChunkCoordMin), cx1 = std::min(chunkX(x1), kChunkCoordMax);
+	int touched = 0;
+	for (int cy = cy0; cy <= cy1; ++cy) {
+		const int oy = cy * chunkSizeY_;
+		for (int cz = cz0; cz <= cz1; ++cz) {
+			const int oz = cz * chunkSizeZ_;
+			for (int cx = cx0; cx <= cx1; ++cx) {
+				const int ox = cx * chunkSizeX_;
+				streamIn(cx, cy, cz, true);
+				Chunk& c = *world_.findChunk(cx, cy, cz);
+				const int lx0 = std::max(x0, ox) - ox, ly0 = std::max(y0, oy) - oy, lz0 = std::max(z0, oz) - oz;
+				const int lx1 = std::min(x1 + 1, ox + chunkSizeX_) - ox;
+				const int ly1 = std::min(y1 + 1, oy + chunkSizeY_) - oy;
+				const int lz1 = std::min(z1 + 1, oz + chunkSizeZ_) - oz;
+				if (journal_) captureBox(c, lx0, ly0, lz0, lx1, ly1, lz1);
+				const bool changed = f(c, cx, cy, cz, lx0, ly0, lz0, lx1, ly1, lz1);
+				if (changed) {
+					if (journal_) journalBox(c, cx, cy, cz, lx0, ly0, lz0, lx1, ly1, lz1);
+					edits_.push(cx, cy, cz);
+					++touched;
+				}
+			}
+		}
+	}
+	return touched;
+}
+
+int WorldManager::fillBox(int x0, int y0, int z0, int x1, int y1, int z1, BlockType t) {
+	return forEachSectionInBox(x0, y0, z0, x1, y1, z1,
+		[&](Chunk& c, int, int, int, int lx0, int ly0, int lz0, int lx1, int ly1, int lz1) {
+			if (c.boxHolds(lx0, ly0, lz0, lx1, ly1, lz1, t)) return false;
+			c.fillBox(lx0, ly0, lz0, lx1, ly1, lz1, t);
+			return true;
+		});
+}
+
+// Largest h with h*h <= v, for v >= 0
+static int isqrt(long long v) {
+	long long h = static_cast<long long>(std::sqrt(static_cast<double>(v)));
+	while (h * h > v) --h;
+	while ((h + 1) * (h + 1) <= v) ++h;
+	return static_cast<int>(h);
+}
+
+int WorldManager::fillSphere(int cx, int cy, int cz, int radius, BlockType t) {
+	if (radius < 0) return 0;
+	const long long r2 = static_cast<long long>(radius) * radius;
+	auto farSq = [](int lo, int hi, int c) {
+		const long long d = std::max(std::abs(lo - c), std::abs(hi - c));
+		return d * d;
+	};
+	return forEachSectionInBox(cx - radius, cy - radius, cz - radius, cx + radius, cy + radius, cz + radius,
+		[&](Chunk& c, int scx, int scy, int scz, int lx0, int ly0, int lz0, int lx1, int ly1, int lz1) {
+			const int ox = scx * chunkSizeX_, oy = scy * chunkSizeY_, oz = scz * chunkSizeZ_;
+			// Overlap entirely inside the sphere: one box fill
+			if (farSq(ox + lx0, ox + lx1 - 1, cx) + farSq(oy + ly0, oy + ly1 - 1, cy) + farSq(oz + lz0, oz + lz1 - 1, cz) <= r2) {
+				if (c.boxHolds(lx0, ly0, lz0, lx1, ly1, lz1, t)) return false;
+				c.fillBox(lx0, ly0, lz0, lx1, ly1, lz1, t);
+				return true;
+			}
+			rowSpans_.clear();
+			for (int ly = ly0; ly < ly1; ++ly) {
+				const long long dy = oy + ly - cy;
+				for (int lz = lz0; lz < lz1; ++lz) {
+					const long long dz = oz + lz - cz;
+					const long long rest = r2 - dy * dy - dz * dz;
+					if (rest < 0) continue;
+					const int half = isqrt(rest);
+					const int sx = std::max(lx0, cx - half - ox);
+					const int ex = std::min(lx1, cx + half + 1 - ox);
+					if (sx >= ex || c.boxHolds(sx, ly, lz, ex, ly + 1, lz + 1, t)) continue;
+					rowSpans_.push_back(RowSpan{ sx, ex, ly, lz, t });
+				}
+			}
+			c.fillRows(rowSpans_.data(), rowSpans_.size());
+			return !rowSpans_.empty();
+		});
+}
+
+int WorldManager::replaceInRegion(int x0, int y0, int z0, int x1, int y1, int z1, BlockType from, BlockType to) {
+	if (from == to) return 0;
+	return forEachSectionInBox(x0, y0, z0, x1, y1, z1,
+		[&](Chunk& c, int, int, int, int lx0, int ly0, int lz0, int lx1, int ly1, int lz1) {
+			return c.replaceInBox(lx0, ly0, lz0, lx1, ly1, lz1, from, to);
+		});
+}
+
+int WorldManager::copyRegion(int x0, int y0, int z0, int x1, int y1, int z1, int dx, int dy, int dz) {
+	if (x0 > x1) std::swap(x0, x1);
+	if (y0 > y1) std::swap(y0, y1);
+	if (z0 > z1) std::swap(z0, z1);
+	const int sx = x1 - x0 + 1, sy = y1 - y0 + 1, sz = z1 - z0 + 1;
+	auto at = [&](int x, int y, int z) {
+		return (static_cast<std::size_t>(y) * sz + z) * sx + x;
+	};
+
+	// Snapshot the source first so overlapping copies read the old contents.
+	// Sections that are not resident (or outside the world) read as air;
+	// one still loading is settled first rather than read as its placeholder.
+	std::vector<BlockType> buffer(static_cast<std::size_t>(sx) * sy * sz, BlockType::Air);
+	for (int cy = chunkY(y0); cy <= chunkY(y1); ++cy) {
+		const int oy = cy * chunkSizeY_;
+		for (int cz = chunkZ(z0); cz <= chunkZ(z1); ++cz) {
+			const int oz = cz * chunkSizeZ_;
+			for (int cx = chunkX(x0); cx <= chunkX(x1); ++cx) {
+				const int ox = cx * chunkSizeX_;
+				if (!chunkKeyInRange(cx, cy, cz)) continue;
+				settleLoad(cx, cy, cz);
+				const Chunk* c = world_.findChunk(cx, cy, cz);
+				if (!c || (c->isUniform() && c->uniformType() == BlockType::Air)) continue;
+				const int wy1 = std::min(y1, oy + chunkSizeY_ - 1);
+				const int wz1 = std::min(z1, oz + chunkSizeZ_ - 1);
+				const int wx0 = std::max(x0, ox), wx1 = std::min(x1, ox + chunkSizeX_ - 1);
+				for (int y = std::max(y0, oy); y <= wy1; ++y)
+					for (int z = std::max(z0, oz); z <= wz1; ++z)
+						for (int x = wx0; x <= wx1; ++x)
+							buffer[at(x - x0, y - y0, z - z0)] = c->get(x - ox, y - oy, z - oz);
+			}
+		}
+	}
+
+	return forEachSectionInBox(dx, dy, dz, dx + sx - 1, dy + sy - 1, dz + sz - 1,
+		[&](Chunk& c, int scx, int scy, int scz, int lx0, int ly0, int lz0, int lx1, int ly1, int lz1) {
+			const int bx = scx * chunkSizeX_ - dx, by = scy * chunkSizeY_ - dy, bz = scz * chunkSizeZ_ - dz;
+			// Each row goes in as runs of one type; a run the section already
+			// holds is skipped, so an unchanged section stays clean
+			rowSpans_.clear();
+			for (int ly = ly0; ly < ly1; ++ly) {
+				for (int lz = lz0; lz < lz1; ++lz) {
+					const BlockType* row = &buffer[at(bx + lx0, by + ly, bz + lz)];
+					for (int lx = lx0; lx < lx1;) {
+						const BlockType t = row[lx - lx0];
+						bool differs = c.get(lx, ly, lz) != t;
+						int end = lx + 1;
+						for (; end < lx1 && row[end - lx0] == t; ++end) differs = differs || c.get(end, ly, lz) != t;
+						if (differs) rowSpans_.push_back(RowSpan{ lx, end, ly, lz, t });
+						lx = end;
+					}
+				}
+			}
+			c.fillRows(rowSpans_.data(), rowSpans_.size());
+			return !rowSpans_.empty();
+		});
+}
+
+} // namespace voxel
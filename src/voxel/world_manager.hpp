@@ -1,5 +1,19 @@
 #pragma once
 
+#include <cstddef>
+#include <cstdint>
+#include <chrono>
+#include <list>
+#include <memory>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+#include "chunk_io_service.hpp"
+#include "edit_journal.hpp"
+#include "edit_queue.hpp"
+#include "region_file.hpp"
 #include "world.hpp"
 
 namespace voxel {
@@ -7,28 +21,180 @@ namespace voxel {
 class WorldManager {
 public:
 	explicit WorldManager(World& world);
+	// Lets loads still in flight on the I/O service land first
+	~WorldManager();
+	WorldManager(const WorldManager&) = delete;
+	WorldManager& operator=(const WorldManager&) = delete;
 
 	void setViewDistance(int chunksRadius);
 	void updatePlayerPosition(float x, float y, float z);
 
+	// Sections streamed in are loaded from region files here when saved.
+	// Empty disables loading and saving; otherwise the directory is created.
+	void setSaveDirectory(const std::string& dir);
+	// Write every dirty section that holds blocks; all-air sections are
+	// skipped (and dropped from their region). Returns the number of
+	// sections written, or -1 when a section could not be staged or a
+	// region not flushed; those stay dirty or staged for the next save.
+	// Through an I/O service failures surface in ChunkIoService::drain.
+	int saveSections();
+	// Route section I/O through a background service (null: synchronous
+	// region files). Streamed sections then appear as air and fill in when
+	// their load completes; an edit to one still loading waits for it.
+	// Saves are written behind from snapshots. updatePlayerPosition resumes
+	// finished loads. The service must outlive this manager.
+	void setIoService(ChunkIoService* io);
+	// Record every edit made through this manager in a write-ahead journal
+	// (null: none). updatePlayerPosition syncs staged edits every
+	// journal_sync_ms and checkpoints once the journal passes
+	// journal_checkpoint_kb. A section is only saved after the journal
+	// entries covering it are on disk. The journal must outlive this manager.
+	void setJournal(EditJournal* journal);
+	// The journal part of updatePlayerPosition, for callers that edit
+	// without streaming: sync staged edits if due, checkpoint if large
+	void syncJournal();
+	// Apply the journal's runs over the saved sections, as on startup after
+	// a crash. Returns the number of runs applied.
+	int replayJournal();
+	// Save every dirty section, force the region files to disk and empty
+	// the journal. Returns the sections written, or -1 when they could not
+	// be made durable; the journal is then kept.
+	int checkpoint();
+
+	std::size_t residentSections() const { return world_.chunkCount(); }
+	std::size_t coldSections() const { return world_.coldCount(); }
+	std::uint64_t evictedSections() const { return evicted_; }
+	// Region file under the save directory that holds a section
+	std::string regionPath(int cx, int cy, int cz) const;
+
 	// Global coordinate voxel access (x,y,z in world space)
-	Voxel* tryGetVoxel(int x, int y, int z);
+	bool tryGetVoxel(int x, int y, int z, Voxel& out);
 	bool setVoxel(int x, int y, int z, const Voxel& v);
 
+	// Bulk edits over inclusive world-space boxes. They walk the affected
+	// sections once each, writing contiguous spans, and create (or load)
+	// sections inside the world's vertical range as needed. Each returns
+	// the number of sections they changed; one already holding the result
+	// is left clean.
+	int fillBox(int x0, int y0, int z0, int x1, int y1, int z1, BlockType t);
+	int fillSphere(int cx, int cy, int cz, int radius, BlockType t);
+	int replaceInRegion(int x0, int y0, int z0, int x1, int y1, int z1, BlockType from, BlockType to);
+	// Copy the source box so its minimum corner lands on (dx, dy, dz).
+	// Overlapping source and destination are handled.
+	int copyRegion(int x0, int y0, int z0, int x1, int y1, int z1, int dx, int dy, int dz);
+
+	// Sections changed since the last call, plus resident neighbours across
+	// any border face the edits touched, each listed once; the caller
+	// remeshes these once per frame instead of remeshing per voxel
+	std::vector<SectionCoord> takeEditedSections() { return edits_.drain(world_); }
+
 private:
 	World& world_;
 	int viewDistance_ { 4 };
+	int verticalViewDistance_ { 2 };
+	int minSectionY_ { 0 };
+	int maxSectionY_ { 3 };
 	int chunkSizeX_ { 16 };
 	int chunkSizeY_ { 16 };
 	int chunkSizeZ_ { 16 };
 	int playerChunkX_ { 0 };
+	int playerChunkY_ { 0 };
 	int playerChunkZ_ { 0 };
+	bool streamed_ { false };
+	std::string saveDir_;
+	// Open region files by packed (region x, cy, region z); null marks a
+	// region known to have no file yet. Section writes are staged in
+	// their region and flushed together (flushRegions).
+	std::unordered_map<std::uint64_t, std::unique_ptr<RegionFile>> regions_;
+	std::vector<std::uint8_t> ioBuffer_;
+	ChunkIoService* io_ { nullptr };
+	// Sections with a load on io_ still in flight, by ticket. Evicting a
+	// section drops its ticket, so a stale load cannot land on the section
+	// streamed in after it.
+	std::unordered_map<std::uint64_t, std::uint64_t> loading_;
+	std::uint64_t nextLoadTicket_ { 0 };
+	EditJournal* journal_ { nullptr };
+	std::chrono::milliseconds journalSyncInterval_ { 50 };
+	std::size_t journalCheckpointBytes_ { 4u << 20 };
+	// Regions saved into since the last checkpoint, keyed like regions_
+	std::unordered_set<std::uint64_t> checkpointRegions_;
+	// World::lostDirtySections as of the last saveSections
+	std::size_t lostDirtySeen_ { 0 };
+	// Types a bulk edit's box held before it, for journaling the change;
+	// a uniform section keeps just its type
+	std::vector<BlockType> journalBefore_;
+	bool journalBeforeUniform_ { false };
+	BlockType journalBeforeType_ { BlockType::Air };
+	// Row runs a bulk edit writes into one section, applied as one batch
+	std::vector<RowSpan> rowSpans_;
 
-	void ensureChunksAround(int cx, int cz);
+	// Unload policy: sections past the view distance plus hysteresis are
+	// dropped; beyond the memory budget the least recently used sections
+	// outside the view go first. The LRU holds packed section keys, most
+	// recently in view at the front, each stamped with the player move
+	// (section change) it was last in view at.
+	// Cold policy: sections out of view for coldAfterMoves_ moves are
+	// compressed in memory (World::freezeChunk) until looked up again.
+	int unloadHysteresis_ { 1 };
+	std::size_t memoryBudget_ { 0 };
+	int coldAfterMoves_ { 2 };
+	std::uint64_t moves_ { 0 };
+	struct LruEntry {
+		std::list<std::uint64_t>::iterator pos;
+		std::uint64_t lastInView;
+	};
+	std::list<std::uint64_t> lru_;
+	std::unordered_map<std::uint64_t, LruEntry> lruPos_;
+	std::uint64_t evicted_ { 0 };
+	EditQueue edits_;
+
+	// Power-of-two chunk sizes split world coordinates with shift/mask
+	bool pow2_ { true };
+	int shiftX_ { 4 };
+	int shiftY_ { 4 };
+	int shiftZ_ { 4 };
+
+	void ensureChunksAround(int cx, int cy, int cz);
+	// wait: the section must hold its saved contents on return, even with
+	// an I/O service (bulk edits write into it straight away)
+	void streamIn(int cx, int cy, int cz, bool wait = false);
+	IoTask loadSection(int cx, int cy, int cz, std::uint64_t ticket);
+	// Block on the section's in-flight load, if any, before it is edited
+	void settleLoad(int cx, int cy, int cz);
+	void installLoaded(int cx, int cy, int cz, std::uint64_t ticket, std::optional<Chunk> loaded);
+	// Overlay what was written to a streaming placeholder onto its load
+	static void mergePlaceholder(const Chunk& placeholder, Chunk& loaded);
+	void touch(std::uint64_t key);
+	bool inView(std::uint64_t key, int margin) const;
+	void unloadOutside();
+	// Returns the bytes saved
+	std::size_t freezeIdle();
+	std::size_t evict(std::uint64_t key);
+	void dropFromLru(std::uint64_t key);
+	// Stage the section's save and clear its dirty flag once staged; with
+	// an I/O service, once the write-behind completes
+	bool saveSection(int cx, int cy, int cz, Chunk& c);
+	IoTask saveBehind(int cx, int cy, int cz, std::uint64_t version, std::shared_ptr<const Chunk> snapshot);
+	RegionFile* region(int cx, int cy, int cz, bool create);
+	// False when a region could not be flushed; its writes stay staged
+	bool flushRegions();
+	void publishCounters(std::size_t bytes) const;
+	// Remember the local box's types, then journal the runs that changed
+	void captureBox(const Chunk& c, int lx0, int ly0, int lz0, int lx1, int ly1, int lz1);
+	void journalBox(const Chunk& c, int cx, int cy, int cz, int lx0, int ly0, int lz0, int lx1, int ly1, int lz1);
+	// Calls f(chunk, cx, cy, cz, lx0, ly0, lz0, lx1, ly1, lz1) for every
+	// section overlapping the inclusive box, with the overlap in local
+	// half-open coordinates
+	template<class F>
+	int forEachSectionInBox(int x0, int y0, int z0, int x1, int y1, int z1, F&& f);
 	static int floorDiv(int a, int b);
 	static int mod(int a, int b);
+	int chunkX(int x) const { return pow2_ ? (x >> shiftX_) : floorDiv(x, chunkSizeX_); }
+	int chunkY(int y) const { return pow2_ ? (y >> shiftY_) : floorDiv(y, chunkSizeY_); }
+	int chunkZ(int z) const { return pow2_ ? (z >> shiftZ_) : floorDiv(z, chunkSizeZ_); }
+	int localX(int x) const { return pow2_ ? (x & (chunkSizeX_ - 1)) : mod(x, chunkSizeX_); }
+	int localY(int y) const { return pow2_ ? (y & (chunkSizeY_ - 1)) : mod(y, chunkSizeY_); }
+	int localZ(int z) const { return pow2_ ? (z & (chunkSizeZ_ - 1)) : mod(z, chunkSizeZ_); }
 };
 
 } // namespace voxel
-
-
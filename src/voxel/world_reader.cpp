@@ -0,0 +1,94 @@
+#include "world_reader.hpp"
+#include "../config/config.hpp"
+#include "chunk_map.hpp"
+
+namespace voxel {
+
+// Regions kept mapped at once before the reader unmaps them all
+static constexpr std::size_t kMaxMappedRegions = 256;
+
+WorldReader::WorldReader(std::string saveDir) : saveDir_(std::move(saveDir)) {
+	const auto& dims = config::Config::instance().chunk();
+	sizeX_ = dims.sizeX;
+	sizeY_ = dims.sizeY;
+	sizeZ_ = dims.sizeZ;
+	layout_ = parseChunkLayout(dims.layout);
+}
+
+int WorldReader::floorDiv(int a, int b) {
+	int q = a / b;
+	int r = a % b;
+	if ((r != 0) && ((r < 0) != (b < 0))) --q;
+	return q;
+}
+
+const MappedRegion* WorldReader::region(int cx, int cy, int cz) {
+	// Out of key range nothing was saved, and the key would alias
+	if (!chunkKeyInRange(cx, cy, cz)) return nullptr;
+	const std::uint64_t key = packChunkKey(regionCoord(cx), cy, regionCoord(cz));
+	auto it = regions_.find(key);
+	if (it != regions_.end()) return it->second.get();
+	if (regions_.size() >= kMaxMappedRegions) {
+		regions_.clear();
+		cacheValid_ = false;
+	}
+	auto file = std::make_unique<MappedRegion>();
+	if (!file->open(regionFilePath(saveDir_, cx, cy, cz))) file.reset();
+	return (regions_[key] = std::move(file)).get();
+}
+
+bool WorldReader::hasSection(int cx, int cy, int cz) {
+	const MappedRegion* r = region(cx, cy, cz);
+	return r && r->has(regionLocal(cx), regionLocal(cz));
+}
+
+bool WorldReader::readSection(int cx, int cy, int cz, Chunk& out) {
+	const MappedRegion* r = region(cx, cy, cz);
+	if (!r) return false;
+	std::size_t size = 0;
+	const std::uint8_t* data = r->payload(regionLocal(cx), regionLocal(cz), size);
+	return data && out.loadFromBuffer(data, size);
+}
+
+std::optional<Chunk> WorldReader::loadSection(int cx, int cy, int cz) {
+	Chunk chunk(sizeX_, sizeY_, sizeZ_, BlockType::Air, layout_);
+	if (!readSection(cx, cy, cz, chunk)) return std::nullopt;
+	return chunk;
+}
+
+BlockType WorldReader::blockAt(int x, int y, int z) {
+	const int cx = floorDiv(x, sizeX_), cy = floorDiv(y, sizeY_), cz = floorDiv(z, sizeZ_);
+	if (!chunkKeyInRange(cx, cy, cz)) return BlockType::Air;
+	const std::uint64_t key = packChunkKey(cx, cy, cz);
+	if (!cacheValid_ || cachedKey_ != key) {
+		if (!cached_) cached_.emplace(sizeX_, sizeY_, sizeZ_, BlockType::Air, layout_);
+		if (!readSection(cx, cy, cz, *cached_)) cached_->fill(BlockType::Air);
+		cachedKey_ = key;
+		cacheValid_ = true;
+	}
+	const int lx = x - cx * sizeX_, ly = y - cy * sizeY_, lz = z - cz * sizeZ_;
+	// A section saved with other dimensions keeps its own shape
+	if (lx >= cached_->sizeX() || ly >= cached_->sizeY() || lz >= cached_->sizeZ()) return BlockType::Air;
+	return cached_->get(lx, ly, lz);
+}
+
+std::size_t WorldReader::mappedRegions() const {
+	std::size_t n = 0;
+	for (const auto& kv : regions_) n += kv.second != nullptr;
+	return n;
+}
+
+std::size_t WorldReader::mappedBytes() const {
+	std::size_t bytes = 0;
+	for (const auto& kv : regions_) {
+		if (kv.second) bytes += kv.second->mappedBytes();
+	}
+	return bytes;
+}
+
+void WorldReader::reset() {
+	regions_.clear();
+	cacheValid_ = false;
+}
+
+} // namespace voxel
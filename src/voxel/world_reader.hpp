@@ -0,0 +1,57 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include "chunk.hpp"
+#include "region_file.hpp"
+
+namespace voxel {
+
+// Read-only access to a saved world, for tools and for processes that
+// share a save directory without owning a World. Region files are mapped
+// (see MappedRegion) when first needed and sections are decoded straight
+// from the mapped pages. Not thread-safe; use one reader per thread.
+class WorldReader {
+public:
+	// Chunk dimensions and layout come from the config, as for World
+	explicit WorldReader(std::string saveDir);
+
+	bool hasSection(int cx, int cy, int cz);
+	// Decode a saved section into out. False when it was never saved, or
+	// is saved as all air, or does not decode; out is then left unchanged.
+	bool readSection(int cx, int cy, int cz, Chunk& out);
+	std::optional<Chunk> loadSection(int cx, int cy, int cz);
+
+	// Block at a world position, Air where nothing is saved. Keeps the
+	// last section it decoded, so nearby lookups cost no further decode.
+	BlockType blockAt(int x, int y, int z);
+
+	// Region files currently mapped, and their bytes of address space
+	std::size_t mappedRegions() const;
+	std::size_t mappedBytes() const;
+	// Unmap everything; files are mapped again on the next lookup
+	void reset();
+
+	const std::string& saveDirectory() const { return saveDir_; }
+
+private:
+	std::string saveDir_;
+	int sizeX_, sizeY_, sizeZ_;
+	ChunkLayout layout_;
+	// Mapped regions by key; null marks a region with no (valid) file
+	std::unordered_map<std::uint64_t, std::unique_ptr<MappedRegion>> regions_;
+	// Section last decoded by blockAt, if any; cachedKey_ names it even
+	// when nothing was saved there
+	std::optional<Chunk> cached_;
+	std::uint64_t cachedKey_ {0};
+	bool cacheValid_ {false};
+
+	const MappedRegion* region(int cx, int cy, int cz);
+	static int floorDiv(int a, int b);
+};
+
+} // namespace voxel